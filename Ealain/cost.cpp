@@ -0,0 +1,172 @@
+#include <algorithm>
+
+#include "utils.h"
+#include "trace.h"
+#include "cost.h"
+
+namespace ealain {
+namespace cost {
+
+bool binary_coverage(group::Group& group, domain::Plan& domain, const double cost_threshold, double& covered,
+        const bool store)
+{
+    if(group.projection().size() != 2) {
+        return false;
+    }
+    const size_t rows = domain.box_size(0);
+    const size_t cols = domain.box_size(1);
+    // Also counts the groups which turn out not to be binary.
+    EALAIN_TRACE(binary, rows * cols);
+    const std::vector<double> xs = group.projection().axis(0, rows);
+    const std::vector<double> ys = group.projection().axis(1, cols);
+
+    domain::Bits high_cells;
+    double low, high;
+    if(not group.binary(high_cells, low, high, xs, ys)) {
+        return false;
+    }
+    assert(high_cells.rows() == rows and high_cells.cols() == cols);
+
+    const size_t high_count = high_cells.count();
+    covered = 0;
+    if(high >= cost_threshold) {
+        covered += high_count;
+    }
+    if(low >= cost_threshold) {
+        covered += rows * cols - high_count;
+    }
+
+    if(not store) {
+        return true;
+    }
+    // Same domain as a full evaluation.
+    for(size_t i = 0; i < rows; ++i) {
+        const domain::Bits::Word* words = high_cells.row(i);
+        double* row = domain.buffer().data() + i * cols;
+        for(size_t j = 0; j < cols; ++j) {
+            row[j] = (words[j / domain::Bits::word_bits] >> (j % domain::Bits::word_bits)) & 1 ? high : low;
+        }
+    }
+    return true;
+}
+
+bool streamed_coverage(group::Group& group, const domain::Plan& domain, const double cost_threshold, double& covered)
+{
+    if(group.projection().size() != 2) {
+        return false;
+    }
+    return group.count(domain.box_size(0), domain.box_size(1), cost_threshold, covered);
+}
+
+IncrementalCoverage::IncrementalCoverage(domain::Plan& domain, group::proba::AtLeastOne& group,
+        const double cost_threshold) :
+    _domain(domain),
+    _group(group),
+    _threshold(cost_threshold),
+    _covered(0)
+{}
+
+double IncrementalCoverage::operator()()
+{
+    EALAIN_TRACE(coverage, _domain.size());
+    _group.evaluate(_domain);
+
+    _axis_i = _group.projection().axis(0, _domain.box_size(0));
+    _axis_j = _group.projection().axis(1, _domain.box_size(1));
+
+    _footprints.clear();
+    _rows.assign(_domain.box_size(0), {});
+    for(size_t s=0; s < _group.size(); ++s) {
+        _footprints.push_back(_group.footprint(s));
+        cover(s, true);
+    }
+
+    _covered = 0;
+    for(const double cell : _domain.buffer()) {
+        if(cell >= _threshold) {
+            _covered++;
+        }
+    }
+    assert(_covered <= _domain.size());
+    return _covered;
+}
+
+double IncrementalCoverage::moved(size_t sensor)
+{
+    assert(_footprints.size() == _group.size());
+    assert(sensor < _footprints.size());
+
+    const geom::Box former = _footprints[sensor];
+    cover(sensor, false);
+    _footprints[sensor] = _group.footprint(sensor);
+    cover(sensor, true);
+
+    refresh(former, nullptr);
+    refresh(_footprints[sensor], &former);
+
+    assert(_covered <= _domain.size());
+    return _covered;
+}
+
+void IncrementalCoverage::cover(size_t sensor, bool add)
+{
+    const geom::Box& box = _footprints[sensor];
+    if(box.row_min >= _rows.size()) {
+        return;
+    }
+    const size_t row_max = std::min(box.row_max, _rows.size()-1);
+    for(size_t i = box.row_min; i <= row_max; ++i) {
+        // Kept sorted, so that each cell aggregates its sensors in group order.
+        std::vector<size_t>& sensors = _rows[i];
+        auto it = std::lower_bound(ALL(sensors), sensor);
+        if(add) {
+            sensors.insert(it, sensor);
+        } else {
+            assert(it != std::end(sensors) and *it == sensor);
+            sensors.erase(it);
+        }
+    }
+}
+
+void IncrementalCoverage::refresh(const geom::Box& box, const geom::Box* excluded)
+{
+    const size_t rows = _domain.box_size(0);
+    const size_t cols = _domain.box_size(1);
+    if(box.row_min >= rows or box.col_min >= cols) {
+        return;
+    }
+    const size_t row_max = std::min(box.row_max, rows-1);
+    const size_t col_max = std::min(box.col_max, cols-1);
+
+    Position position(2);
+    for(size_t i = box.row_min; i <= row_max; ++i) {
+        position[0] = _axis_i[i];
+        double* row = _domain.buffer().data() + i * cols;
+        for(size_t j = box.col_min; j <= col_max; ++j) {
+            if(excluded and excluded->contains(i,j)) {
+                continue;
+            }
+            position[1] = _axis_j[j];
+
+            // Probability of having no detection whatsoever, as in AtLeastOne::sense.
+            double none = 1.0;
+            for(const size_t s : _rows[i]) {
+                if(_footprints[s].col_min <= j and j <= _footprints[s].col_max) {
+                    none = none * (1 - _group.at(s)(position));
+                }
+            }
+            const double cell = _group.detection(none);
+
+            if(row[j] >= _threshold) {
+                _covered--;
+            }
+            if(cell >= _threshold) {
+                _covered++;
+            }
+            row[j] = cell;
+        }
+    }
+}
+
+} // cost
+} // ealain
@@ -1,8 +1,14 @@
 #ifndef __EALAIN_COST_H__
 #define __EALAIN_COST_H__
 
+#include <array>
+
+#include "trace.h"
 #include "detection/group.h"
 #include "map/domain.h"
+#include "map/cache.h"
+#include "map/instance.h"
+#include "map/shared.h"
 
 namespace ealain {
 
@@ -26,16 +32,24 @@ namespace ealain {
                 virtual double operator()(group::Group& group) = 0;
         };
 
-        // Compute the number of cells which values are greater than or equal to a threshold.
+        /** Compute the number of cells which values are greater than or equal to a threshold.
+         *
+         * The group is evaluated in place, in the domain.
+         * In reduction-only mode (store = false), covered cells are counted while rows are combined,
+         * and the domain is left untouched, only its shape being used,
+         * unless the group cannot be evaluated by rows.
+         */
         template<class D>
         class Coverage: public Cost<D>
         {
             protected:
                 const double _threshold;
+                const bool _store;
             public:
-                Coverage(D& domain, const double cost_threshold = 0) :
+                Coverage(D& domain, const double cost_threshold = 0, const bool store = true) :
                     Cost<D>(domain),
-                    _threshold(cost_threshold)
+                    _threshold(cost_threshold),
+                    _store(store)
                 {}
 
                 virtual double operator()(group::Group& group);
@@ -44,6 +58,150 @@ namespace ealain {
         template<class D>
         Coverage<D> make_coverage(D& domain);
 
+        /** Coverage of a group over a 2D domain, if the group only senses two values there.
+         *
+         * Builds the bit-packed union of the cells where the sensors detect (see group::Group::binary),
+         * counts it with popcount, and, if store, fills the domain with the two values.
+         * Gives exactly the same domain and coverage as evaluating the group.
+         *
+         * Return false if the group cannot be evaluated this way, leaving the domain untouched.
+         */
+        bool binary_coverage(group::Group& group, domain::Plan& domain, const double cost_threshold, double& covered,
+                const bool store = true);
+
+        // No bit-packed evaluation for other domains.
+        template<class D>
+        bool binary_coverage(group::Group&, D&, const double, double&, const bool = true) {return false;}
+
+        /** Coverage of a group over the cells of a 2D domain, without writing it, see group::Group::count.
+         *
+         * Return false if the group cannot be evaluated by rows.
+         */
+        bool streamed_coverage(group::Group& group, const domain::Plan& domain, const double cost_threshold, double& covered);
+
+        // No streamed evaluation for other domains.
+        template<class D>
+        bool streamed_coverage(group::Group&, const D&, const double, double&) {return false;}
+
+        /** Coverage of a whole population of camera layouts on the same map.
+         *
+         * Each layout is evaluated as a Coverage of an AtLeastOne group of cameras of type C,
+         * all built with the same range.
+         * Layouts are split in tiles across threads,
+         * each thread reusing its own domain, cameras and group from one layout to the next.
+         * Visibility maps may be shared through a cache.
+         *
+         * Fitnesses are exactly the ones separate Coverage evaluations would give.
+         */
+        template<class C>
+        class Population
+        {
+            protected:
+                // Map of the cameras, nullptr if built from a shared instance, on which cameras are then built.
+                const inst::Map* _map;
+                const proj::Projection<double,size_t>& _proj;
+                const double _range;
+                const double _threshold;
+                geom::VisibilityCache* _cache;
+                // Keeps the instance alive, if built from a shared one.
+                const inst::Shared _instance;
+
+                // Coverage of the cameras at the given real-world coordinates, using the given scratch objects.
+                double evaluate(const std::vector<std::array<double,2>>& positions,
+                        domain::Plan& domain, std::vector<C>& cameras, group::proba::AtLeastOne& group) const;
+
+                // Evaluate positions(k, out) for each k in [0,n), across threads.
+                template<class F>
+                std::vector<double> evaluate(size_t n, F positions, size_t threads) const;
+
+            public:
+                /** Constructor
+                 *
+                 * range range of all the cameras.
+                 * cost_threshold minimum probability of detection of a covered cell.
+                 * cache shared visibility maps, if any, which should outlive the population.
+                 */
+                Population(const inst::Map& map, const proj::Projection<double,size_t>& p,
+                        const double range, const double cost_threshold = 0,
+                        geom::VisibilityCache* cache = nullptr);
+
+                // On a shared instance, kept alive by the population, sharing its cache if any.
+                Population(const inst::Shared& instance, const double range, const double cost_threshold = 0);
+
+                // Fitness of each layout given as real-world coordinates: {x_0, y_0, x_1, y_1, …}.
+                std::vector<double> coordinates(const std::vector<std::vector<double>>& layouts, size_t threads = 0) const;
+
+                /** Fitness of each layout given as normalized coordinates: {x_0, y_0, x_1, y_1, …}.
+                 *
+                 * Each coordinate in [0,1] spans the real-world range of its axis.
+                 * threads 0 means the hardware concurrency.
+                 */
+                std::vector<double> numeric(const std::vector<std::vector<double>>& layouts, size_t threads = 0) const;
+
+                /** Fitness of each layout given as a bitstring over the cells of the map, in row-major order.
+                 *
+                 * A camera is placed on the real-world coordinates of each cell which bit is set.
+                 */
+                std::vector<double> bits(const std::vector<std::vector<bool>>& layouts, size_t threads = 0) const;
+        };
+
+        /** Coverage of an AtLeastOne group over a 2D domain, updated incrementally when a sensor changes.
+         *
+         * A full evaluation (operator()) computes the domain and the coverage,
+         * and records the footprint of each sensor.
+         * Then, after a single sensor has moved (and its visibility has been updated),
+         * moved() only recomputes the cells of its former and new footprints,
+         * only visiting, on each row, the sensors which footprint covers it.
+         *
+         * Both the domain and the coverage are then exactly the ones a full evaluation would give,
+         * as each cell aggregates its sensors in the same order.
+         */
+        class IncrementalCoverage
+        {
+            protected:
+                domain::Plan& _domain;
+                group::proba::AtLeastOne& _group;
+                const double _threshold;
+
+                // Footprint of each sensor of the group, as of the last evaluation.
+                std::vector<geom::Box> _footprints;
+
+                // Sensors which footprint covers each row of the domain, in group order.
+                std::vector<std::vector<size_t>> _rows;
+
+                // Numerical coordinates of the indices of each axis of the domain.
+                std::vector<double> _axis_i;
+                std::vector<double> _axis_j;
+
+                // Number of cells which values are greater than or equal to the threshold.
+                double _covered;
+
+                // Add the sensor to the rows covered by its footprint, or remove it from them.
+                void cover(size_t sensor, bool add);
+
+                // Recompute the cells of the given box which are not in the excluded one.
+                void refresh(const geom::Box& box, const geom::Box* excluded);
+
+            public:
+                IncrementalCoverage(domain::Plan& domain, group::proba::AtLeastOne& group,
+                        const double cost_threshold = 0);
+
+                domain::Plan& domain() {return _domain;}
+
+                // Full evaluation of the group, returns the coverage.
+                double operator()();
+
+                /** Update after the given sensor of the group has changed, returns the new coverage.
+                 *
+                 * Takes time proportional to the former and new footprints of the sensor,
+                 * times the number of sensors sharing their rows.
+                 */
+                double moved(size_t sensor);
+
+                // Coverage as of the last evaluation.
+                double value() const {return _covered;}
+        };
+
     } // cost
 
 } // ealain
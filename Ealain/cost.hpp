@@ -6,9 +6,19 @@ namespace ealain {
         template<class D>
         double Coverage<D>::operator()(group::Group& group)
         {
-            this->_domain = group(this->_domain);
-
+            EALAIN_TRACE(coverage, this->_domain.size());
             double n = 0;
+            // Groups of binary sensors are counted word by word.
+            group.prepare();
+            if(binary_coverage(group, this->_domain, _threshold, n, _store)) {
+                return n;
+            }
+            if(not _store and streamed_coverage(group, this->_domain, _threshold, n)) {
+                return n;
+            }
+
+            group.evaluate(this->_domain);
+
             // Loop over each cells of the domain
             for(auto it = ealain::begin(this->_domain); it != ealain::end(this->_domain); it++) {
                 if( *it >= _threshold ) {
@@ -25,6 +35,137 @@ namespace ealain {
             return Coverage<D>(domain, cost_threshold);
         }
 
+        template<class C>
+        Population<C>::Population(const inst::Map& map, const proj::Projection<double,size_t>& p,
+                const double range, const double cost_threshold, geom::VisibilityCache* cache) :
+            _map(&map),
+            _proj(p),
+            _range(range),
+            _threshold(cost_threshold),
+            _cache(cache)
+        {
+            assert(_proj.size() == 2);
+        }
+
+        template<class C>
+        Population<C>::Population(const inst::Shared& instance, const double range, const double cost_threshold) :
+            _map(nullptr),
+            _proj(instance->projection()),
+            _range(range),
+            _threshold(cost_threshold),
+            _cache(instance->cache()),
+            _instance(instance)
+        {
+            assert(_proj.size() == 2);
+        }
+
+        template<class C>
+        double Population<C>::evaluate(const std::vector<std::array<double,2>>& positions,
+                domain::Plan& domain, std::vector<C>& cameras, group::proba::AtLeastOne& group) const
+        {
+            // Cameras are bound by reference, build them all before binding.
+            cameras.clear();
+            for(const auto& xy : positions) {
+                if(_instance) {
+                    // Already sharing the cache of the instance.
+                    cameras.emplace_back(_instance, xy[0], xy[1], _range);
+                } else {
+                    cameras.emplace_back(*_map, _proj, xy[0], xy[1], _range);
+                    if(_cache) {
+                        cameras.back().geo.cache(_cache);
+                    }
+                }
+            }
+            group.clear();
+            for(auto& camera : cameras) {
+                group.bind(camera);
+            }
+            // Only the coverage matters, the domain is never written.
+            EALAIN_TRACE(coverage, domain.size());
+            double n = 0;
+            group.prepare();
+            if(binary_coverage(group, domain, _threshold, n, false)) {
+                return n;
+            }
+            if(streamed_coverage(group, domain, _threshold, n)) {
+                return n;
+            }
+
+            group.evaluate(domain);
+            for(const double cell : domain.buffer()) {
+                if(cell >= _threshold) {
+                    n++;
+                }
+            }
+            return n;
+        }
+
+        template<class C>
+        template<class F>
+        std::vector<double> Population<C>::evaluate(size_t n, F positions, size_t threads) const
+        {
+            std::vector<double> fitnesses(n, 0);
+            parallel_tiles(n, threads, [&](size_t first, size_t last) {
+                // Scratch objects of this thread.
+                domain::Plan domain(_proj, 0);
+                std::vector<C> cameras;
+                group::proba::AtLeastOne group(_proj);
+                std::vector<std::array<double,2>> xy;
+                for(size_t k = first; k < last; ++k) {
+                    positions(k, xy);
+                    fitnesses[k] = evaluate(xy, domain, cameras, group);
+                }
+            });
+            return fitnesses;
+        }
+
+        template<class C>
+        std::vector<double> Population<C>::coordinates(const std::vector<std::vector<double>>& layouts, size_t threads) const
+        {
+            return evaluate(layouts.size(), [&](size_t k, std::vector<std::array<double,2>>& xy) {
+                const auto& layout = layouts[k];
+                assert(layout.size() % 2 == 0);
+                xy.clear();
+                for(size_t c = 0; c < layout.size(); c += 2) {
+                    xy.push_back({layout[c], layout[c+1]});
+                }
+            }, threads);
+        }
+
+        template<class C>
+        std::vector<double> Population<C>::numeric(const std::vector<std::vector<double>>& layouts, size_t threads) const
+        {
+            return evaluate(layouts.size(), [&](size_t k, std::vector<std::array<double,2>>& xy) {
+                const auto& layout = layouts[k];
+                assert(layout.size() % 2 == 0);
+                xy.clear();
+                for(size_t c = 0; c < layout.size(); c += 2) {
+                    std::array<double,2> position;
+                    for(size_t d = 0; d < 2; ++d) {
+                        const auto& range = _proj[d].range_irl();
+                        position[d] = range.min() + layout[c+d] * (range.max() - range.min());
+                    }
+                    xy.push_back(position);
+                }
+            }, threads);
+        }
+
+        template<class C>
+        std::vector<double> Population<C>::bits(const std::vector<std::vector<bool>>& layouts, size_t threads) const
+        {
+            const size_t cols = _proj[1].range_idx().max() + 1;
+            return evaluate(layouts.size(), [&](size_t k, std::vector<std::array<double,2>>& xy) {
+                const auto& layout = layouts[k];
+                assert(layout.size() == (_proj[0].range_idx().max() + 1) * cols);
+                xy.clear();
+                for(size_t cell = 0; cell < layout.size(); ++cell) {
+                    if(layout[cell]) {
+                        xy.push_back({_proj[0](cell / cols), _proj[1](cell % cols)});
+                    }
+                }
+            }, threads);
+        }
+
     } // cost
 
 } // ealain
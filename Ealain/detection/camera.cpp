@@ -1,6 +1,7 @@
 #include "../utils.h"
 #include "../map/geom.h"
 #include "camera.h"
+#include "kernel.h"
 
 namespace ealain {
 namespace camera {
@@ -16,13 +17,13 @@ double Omnidir::sense(const Position& position)
     const double d = _eps + geom::ground_distance(target_x, target_y, radar_x, radar_y);
 
     // 2D visibility map
-    const double v = geo({position[0],position[1]});
+    const double v = geo(position);
     assert(v==0 or v==1);
 
-    if(v == 0 or d > range) {
+    if(v == 0 or d > _range) {
         return 0;
     } else {
-        double p = (range-d)/range;
+        double p = (_range-d)/_range;
         // In case output > 1
         if(p>1) {
             return 1;
@@ -33,6 +34,12 @@ double Omnidir::sense(const Position& position)
     }
 }
 
+void Omnidir::sense_row(double x, const double* ys, size_t n, double* values)
+{
+    geo.row(x, ys, n, values);
+    kernel::falloff(values, x, ys, n, geo.x, geo.y, _range, _eps);
+}
+
 double Omnibinary::sense(const Position& position)
 {
     assert(position.size() >= 2);
@@ -44,15 +51,131 @@ double Omnibinary::sense(const Position& position)
     const double d = _eps + geom::ground_distance(target_x, target_y, radar_x, radar_y);
 
     // 2D visibility map (0 or 1),
-    const double v = geo({position[0],position[1]});
+    const double v = geo(position);
     assert(v==0 or v==1);
 
-    if(v == 0 or d > range) {
+    if(v == 0 or d > _range) {
         return 0;
     } else {
         return 1;
         }
 }
 
+void Omnibinary::sense_row(double x, const double* ys, size_t n, double* values)
+{
+    geo.row(x, ys, n, values);
+    kernel::disc(values, x, ys, n, geo.x, geo.y, _range, _eps);
+}
+
+bool Omnibinary::in_range(double x, double y) const
+{
+    return not (_eps + geom::ground_distance(x, y, geo.x, geo.y) > _range);
+}
+
+bool Omnibinary::detected(domain::Bits& cells, geom::Box& box,
+        const std::vector<double>& xs, const std::vector<double>& ys, double threshold)
+{
+    using Word = domain::Bits::Word;
+    const size_t W = domain::Bits::word_bits;
+
+    assert(threshold >= 0);
+    box = geo.footprint();
+    const geom::Box& seen = geo.box();
+    if(xs.empty() or ys.empty() or box.row_min >= xs.size() or box.col_min >= ys.size() or threshold >= 1) {
+        // Nothing exceeds the threshold within the domain.
+        cells = domain::Bits();
+        return true;
+    }
+    box.row_max = std::min(box.row_max, xs.size()-1);
+    box.col_max = std::min(box.col_max, ys.size()-1);
+
+    const domain::Bits& visible = geo.visibility();
+    // Pixels of the visibility map at the columns of the footprint, as sense() looks them up.
+    // If they are the columns themselves, whole words of the visibility map are used.
+    std::vector<size_t> pixels(box.cols());
+    bool aligned = seen.col_min == box.col_min;
+    for(size_t j = box.col_min; j <= box.col_max; ++j) {
+        pixels[j - box.col_min] = _proj.idx(1, ys[j]);
+        aligned = aligned and pixels[j - box.col_min] == j;
+    }
+
+    cells = domain::Bits(box.rows(), box.cols());
+    const size_t center = std::min(std::max(_proj.idx(1, geo.y), box.col_min), box.col_max);
+    for(size_t i = box.row_min; i <= box.row_max; ++i) {
+        const double x = xs[i];
+        const size_t row = _proj.idx(0, x);
+        if(row < seen.row_min or row > seen.row_max) {
+            continue;
+        }
+
+        // The distance is monotonic along the row on both sides of the camera,
+        // so cells within range form an interval [first,last].
+        size_t first = box.col_max + 1;
+        size_t last = box.col_min;
+        if(in_range(x, ys[center])) {
+            size_t lo = box.col_min;
+            size_t hi = center;
+            while(lo < hi) {
+                const size_t mid = lo + (hi-lo)/2;
+                if(in_range(x, ys[mid])) {
+                    hi = mid;
+                } else {
+                    lo = mid+1;
+                }
+            }
+            first = lo;
+            lo = center;
+            hi = box.col_max;
+            while(lo < hi) {
+                const size_t mid = lo + (hi-lo+1)/2;
+                if(in_range(x, ys[mid])) {
+                    lo = mid;
+                } else {
+                    hi = mid-1;
+                }
+            }
+            last = lo;
+        } else {
+            // The interval, if any, does not contain the column of the camera.
+            for(size_t j = box.col_min; j <= box.col_max; ++j) {
+                if(in_range(x, ys[j])) {
+                    first = std::min(first, j);
+                    last = j;
+                }
+            }
+        }
+        if(first > last) {
+            continue;
+        }
+
+        const Word* vis = visible.row(row - seen.row_min);
+        Word* out = cells.row(i - box.row_min);
+        const size_t from = first - box.col_min;
+        const size_t to = last - box.col_min;
+        if(aligned) {
+            // Visibility words masked to the interval.
+            for(size_t w = from / W; w <= to / W; ++w) {
+                Word mask = ~Word(0);
+                if(w == from / W) {
+                    mask &= mask << (from % W);
+                }
+                if(w == to / W and to % W != W - 1) {
+                    mask &= (Word(1) << (to % W + 1)) - 1;
+                }
+                out[w] = vis[w] & mask;
+            }
+        } else {
+            for(size_t j = from; j <= to; ++j) {
+                const size_t c = pixels[j];
+                if(c >= seen.col_min and c <= seen.col_max
+                   and (vis[(c - seen.col_min) / W] >> ((c - seen.col_min) % W)) & 1) {
+                    out[j / W] |= Word(1) << (j % W);
+                }
+            }
+        }
+    }
+    return true;
+}
+
 } // camera
 } // ealain
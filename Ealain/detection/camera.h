@@ -17,7 +17,6 @@ namespace ealain {
         class Omnidir : public sensor::Sensor<2>
         {
             public:
-                double range;
                 sensor::Situated geo;
 
                 Omnidir(
@@ -26,10 +25,9 @@ namespace ealain {
                     const double range_
                 ) :
                     sensor::Sensor<2>(p),
-                    range(range_),
                     geo(map,p)
                 {
-                    assert(range >= 0);
+                    range(range_);
                 }
 
                 Omnidir(
@@ -40,10 +38,24 @@ namespace ealain {
                     const double range_
                 ) :
                     sensor::Sensor<2>(p),
-                    range(range_),
                     geo(map,p,x,y)
                 {
-                    assert(range >= 0);
+                    range(range_);
+                }
+
+                // On a shared instance, kept alive by the camera.
+                Omnidir(const inst::Shared& instance, const double range_) :
+                    sensor::Sensor<2>(instance->projection()),
+                    geo(instance)
+                {
+                    range(range_);
+                }
+
+                Omnidir(const inst::Shared& instance, const double x, const double y, const double range_) :
+                    sensor::Sensor<2>(instance->projection()),
+                    geo(instance,x,y)
+                {
+                    range(range_);
                 }
 
                 Omnidir(
@@ -55,18 +67,36 @@ namespace ealain {
                     const double range_
                 ) :
                     sensor::Sensor<2>(p),
-                    range(range_),
                     geo(map,p,bit,x,y)
                 {
-                    assert(range >= 0);
+                    range(range_);
                 }
 
+                double range() const {return _range;}
+
+                // Nothing is sensed farther than range, which also bounds the visibility box of geo.
+                void range(double r)
+                {
+                    assert(r >= 0);
+                    _range = r;
+                    geo.radius(r);
+                }
+
+                // Nothing is sensed outside of the visibility box.
+                virtual geom::Box footprint() {return geo.footprint();}
+
+                virtual void prepare() {geo.prepare();}
+
             protected:
+                double _range;
                 const double _eps = 1e-6;
 
                 // Linear function starting at 1 and decreasing to 0 when reaching range.
                 virtual double sense(const Position& position);
 
+                // Visibility of the row from geo, then the same falloff, vectorized.
+                virtual void sense_row(double x, const double* ys, size_t n, double* values);
+
         };
 
         /** Simple camera seing around
@@ -76,7 +106,6 @@ namespace ealain {
         class Omnibinary : public sensor::Sensor<2>
         {
             public:
-                double range;
                 sensor::Situated geo;
 
                 Omnibinary(
@@ -85,10 +114,9 @@ namespace ealain {
                     const double range_
                 ) :
                     sensor::Sensor<2>(p),
-                    range(range_),
                     geo(map,p)
                 {
-                    assert(range >= 0);
+                    range(range_);
                 }
 
                 Omnibinary(
@@ -99,10 +127,24 @@ namespace ealain {
                     const double range_
                 ) :
                     sensor::Sensor<2>(p),
-                    range(range_),
                     geo(map,p,x,y)
                 {
-                    assert(range >= 0);
+                    range(range_);
+                }
+
+                // On a shared instance, kept alive by the camera.
+                Omnibinary(const inst::Shared& instance, const double range_) :
+                    sensor::Sensor<2>(instance->projection()),
+                    geo(instance)
+                {
+                    range(range_);
+                }
+
+                Omnibinary(const inst::Shared& instance, const double x, const double y, const double range_) :
+                    sensor::Sensor<2>(instance->projection()),
+                    geo(instance,x,y)
+                {
+                    range(range_);
                 }
 
                 Omnibinary(
@@ -114,17 +156,47 @@ namespace ealain {
                     const double range_
                 ) :
                     sensor::Sensor<2>(p),
-                    range(range_),
                     geo(map,p,bit,x,y)
                 {
-                    assert(range >= 0);
+                    range(range_);
+                }
+
+                double range() const {return _range;}
+
+                // Nothing is sensed farther than range, which also bounds the visibility box of geo.
+                void range(double r)
+                {
+                    assert(r >= 0);
+                    _range = r;
+                    geo.radius(r);
                 }
 
+                // Nothing is sensed outside of the visibility box.
+                virtual geom::Box footprint() {return geo.footprint();}
+
+                virtual void prepare() {geo.prepare();}
+
             protected:
+                double _range;
                 const double _eps = 1e-6;
 
                 virtual double sense(const Position& position);
 
+                // Visibility of the row from geo, then the same disc test on squared distances, vectorized.
+                virtual void sense_row(double x, const double* ys, size_t n, double* values);
+
+                // True if the position is within range, exactly as sense() decides.
+                bool in_range(double x, double y) const;
+
+            public:
+                /** Visible cells within range, as the visibility map ANDed with the range disc.
+                 *
+                 * Whole words of the visibility map are used if the columns of the domain are the ones of the map,
+                 * bits are gathered otherwise.
+                 */
+                virtual bool detected(domain::Bits& cells, geom::Box& box,
+                        const std::vector<double>& xs, const std::vector<double>& ys, double threshold);
+
         };
 
     } // camera
@@ -1,10 +1,14 @@
+#include <atomic>
+#include <algorithm>
+
 #include "../utils.h"
+#include "../trace.h"
 #include "group.h"
 
 namespace ealain {
 namespace group {
 
-Group::Group(proj::Projection<double,size_t>& p) :
+Group::Group(const proj::Projection<double,size_t>& p) :
     sensor::Detector(p)
 {}
 
@@ -15,6 +19,119 @@ void Group::bind(sensor::Detector& sensor)
     this->push_back(sensor);
 }
 
+void Group::prepare()
+{
+    for(auto&& sensor : *this) {
+        sensor.get().prepare();
+    }
+}
+
+geom::Box Group::footprint(size_t s)
+{
+    sensor::Detector& sensor = this->at(s).get();
+    if(sensor.projection().matches(_proj)) {
+        return sensor.footprint();
+    }
+    return footprint();
+}
+
+Group::Layout Group::layout(size_t rows, size_t cols)
+{
+    Layout layout;
+    layout.axis_i = _proj.axis(0, rows);
+    layout.axis_j = _proj.axis(1, cols);
+    for(size_t s=0; s < this->size(); ++s) {
+        layout.boxes.push_back(footprint(s));
+    }
+    return layout;
+}
+
+bool Group::combines() const
+{
+    return false;
+}
+
+void Group::combine(const Layout&, size_t, double*, double*)
+{
+    assert(false);
+}
+
+bool Group::rows(domain::Plan& out, size_t threads)
+{
+    assert(out.dimension == _proj.size());
+    if(not this->combines()) {
+        return false;
+    }
+    const size_t rows = out.box_size(0);
+    const size_t cols = out.box_size(1);
+    EALAIN_TRACE(rows, rows * cols);
+    if(rows == 0 or cols == 0) {
+        return true;
+    }
+    const Layout shape = layout(rows, cols);
+    parallel_tiles(rows, threads, [&](size_t first, size_t last) {
+        std::vector<double> values(cols);
+        for(size_t i = first; i < last; ++i) {
+            this->combine(shape, i, out.buffer().data() + i * cols, values.data());
+        }
+    });
+    return true;
+}
+
+bool Group::count(size_t rows, size_t cols, double threshold, double& covered, size_t threads)
+{
+    assert(_proj.size() == 2);
+    if(not this->combines()) {
+        return false;
+    }
+    EALAIN_TRACE(rows, rows * cols);
+    covered = 0;
+    if(rows == 0 or cols == 0) {
+        return true;
+    }
+    const Layout shape = layout(rows, cols);
+    std::atomic<size_t> total(0);
+    parallel_tiles(rows, threads, [&](size_t first, size_t last) {
+        std::vector<double> cells(cols);
+        std::vector<double> values(cols);
+        size_t n = 0;
+        for(size_t i = first; i < last; ++i) {
+            this->combine(shape, i, cells.data(), values.data());
+            for(const double cell : cells) {
+                if(cell >= threshold) {
+                    n++;
+                }
+            }
+        }
+        total += n;
+    });
+    covered = total;
+    return true;
+}
+
+bool Group::binary(domain::Bits&, double&, double&, const std::vector<double>&, const std::vector<double>&)
+{
+    return false;
+}
+
+bool Group::unite(domain::Bits& cells, const std::vector<double>& xs, const std::vector<double>& ys, double threshold)
+{
+    cells = domain::Bits(xs.size(), ys.size());
+    domain::Bits detected;
+    geom::Box box;
+    for(auto&& sensor : *this) {
+        // Detected cells are located by footprints, which are in the indices of the sensor.
+        if(not sensor.get().projection().matches(_proj)
+           or not sensor.get().detected(detected, box, xs, ys, threshold)) {
+            return false;
+        }
+        if(detected.rows() > 0 and detected.cols() > 0) {
+            cells.merge(detected, box.row_min, box.col_min);
+        }
+    }
+    return true;
+}
+
 
 namespace proba {
 
@@ -25,12 +142,17 @@ namespace proba {
         for(auto&& sense : *this) {
             cost = cost * (1 - sense(position));
         }
-        if(cost < 0.0) {
-            cost = 0.0;
+        return detection(cost);
+    }
+
+    double AtLeastOne::detection(double none) const
+    {
+        if(none < 0.0) {
+            none = 0.0;
         }
-        assert(is_proba(cost));
+        assert(is_proba(none));
         // Probability of having at least one detection.
-        const double res = 1 - cost;
+        const double res = 1 - none;
         assert(is_proba(res));
         if(res < _min) {
             return _min;
@@ -41,6 +163,27 @@ namespace proba {
         }
     }
 
+    bool AtLeastOne::binary(domain::Bits& high_cells, double& low, double& high,
+            const std::vector<double>& xs, const std::vector<double>& ys)
+    {
+        // Sensing 1 cancels the probability of non-detection, 0 leaves it unchanged.
+        if(not this->unite(high_cells, xs, ys, 0)) {
+            return false;
+        }
+        low = detection(1.0);
+        high = detection(0.0);
+        return true;
+    }
+
+    void AtLeastOne::combine(const Layout& layout, size_t i, double* cells, double* values)
+    {
+        const size_t cols = layout.axis_j.size();
+        // Probability of having no detection whatsoever
+        std::fill(cells, cells + cols, 1.0);
+        this->scatter(layout, i, cells, values, kernel::complement_product, false);
+        kernel::at_least_one(cells, cols, _min, _max);
+    }
+
 } // proba
 
 double Aggregate::sense(const Position& position)
@@ -52,6 +195,13 @@ double Aggregate::sense(const Position& position)
     return cost;
 }
 
+void Aggregate::combine(const Layout& layout, size_t i, double* cells, double* values)
+{
+    assert(_kernel);
+    std::fill(cells, cells + layout.axis_j.size(), _init);
+    this->scatter(layout, i, cells, values, _kernel, not _sparse);
+}
+
     double Binary::sense(const Position& position)
     {
         double cost = 0;
@@ -64,5 +214,28 @@ double Aggregate::sense(const Position& position)
         return cost;
     }
 
+    bool Binary::binary(domain::Bits& high_cells, double& low, double& high,
+            const std::vector<double>& xs, const std::vector<double>& ys)
+    {
+        low = 0;
+        high = 1;
+        if(_threshold < 0) {
+            // Zero exceeds a negative threshold, every cell is covered by any sensor.
+            high_cells = domain::Bits(xs.size(), ys.size(), not this->empty());
+            return true;
+        }
+        return this->unite(high_cells, xs, ys, _threshold);
+    }
+
+    void Binary::combine(const Layout& layout, size_t i, double* cells, double* values)
+    {
+        std::fill(cells, cells + layout.axis_j.size(), 0.0);
+        const double threshold = _threshold;
+        // Zero only exceeds a negative threshold.
+        this->scatter(layout, i, cells, values, [threshold](double* row, const double* sensed, size_t n) {
+            kernel::threshold(row, sensed, n, threshold);
+        }, _threshold < 0);
+    }
+
 } // net
 } // ealain
@@ -4,6 +4,7 @@
 #include "../map/geom.h"
 #include "../map/projection.h"
 #include "sensor.h"
+#include "kernel.h"
 #include <limits>
 #include <cassert>
 
@@ -19,10 +20,10 @@ namespace ealain {
         {
             public:
                 // Empty constructor.
-                Group(proj::Projection<double,size_t>& p);
+                Group(const proj::Projection<double,size_t>& p);
 
                 // Constructor with mandatory list of references.
-                Group(proj::Projection<double,size_t>& p,
+                Group(const proj::Projection<double,size_t>& p,
                         std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors ) :
                     sensor::Detector(p),
                     std::vector<std::reference_wrapper<sensor::Detector>>(detectors)
@@ -31,8 +32,115 @@ namespace ealain {
                 // Just a proxy to push_back
                 void bind(sensor::Detector& sensor);
 
+                // Read access to the bound sensors, in binding order.
+                using std::vector<std::reference_wrapper<sensor::Detector>>::size;
+                using std::vector<std::reference_wrapper<sensor::Detector>>::at;
+
+                // Unbind all the sensors.
+                using std::vector<std::reference_wrapper<sensor::Detector>>::clear;
+
+                using sensor::Detector::footprint;
+
+                /** Footprint of the s-th bound sensor, in the indices of the domains of this group.
+                 *
+                 * A sensor which projection does not match the one of the group (see Projection::matches)
+                 * may sense anywhere: its footprint is then the whole indexed space of the group.
+                 */
+                geom::Box footprint(size_t s);
+
+                using sensor::Detector::operator();
+
+                /** Call this group on all cells of the given domain.
+                 *
+                 * On 2D domains, groups that support it combine whole rows of sensed values at once,
+                 * see rows().
+                 * Other groups and domains fall back to calling sense() on every cell.
+                 */
+                template<class D>
+                D operator()(const D& domain);
+
+                // Same as above, in place, with rows split in tiles across the given number of threads.
+                template<class D>
+                void evaluate(D& out, size_t threads = 1);
+
+                // Prepare all the sensors.
+                virtual void prepare();
+
+                /** Evaluate the group on a 2D domain where it only senses two values, as a bit-packed map.
+                 *
+                 * xs and ys are the numerical coordinates of the rows and columns of the domain.
+                 * On return, the set cells of high sense high, and all the others sense low.
+                 * Sensors should be prepared.
+                 *
+                 * Return false (the default) if the group or its sensors cannot be evaluated this way.
+                 */
+                virtual bool binary(domain::Bits& high_cells, double& low, double& high,
+                        const std::vector<double>& xs, const std::vector<double>& ys);
+
+                /** Count the cells of a 2D domain of the given sizes which values are greater than or equal to threshold.
+                 *
+                 * Rows of values are combined in a scratch row and counted right away,
+                 * so that no domain is ever written.
+                 * Rows are split in tiles across the given number of threads, which does not change the result.
+                 * Sensors should be prepared.
+                 *
+                 * Return false if this group cannot be evaluated by rows.
+                 */
+                bool count(size_t rows, size_t cols, double threshold, double& covered, size_t threads = 1);
+
                 virtual ~Group() {};
 
+            protected:
+                // What combining rows needs to know about a 2D domain.
+                struct Layout
+                {
+                    // Numerical coordinates of the rows and columns.
+                    std::vector<double> axis_i;
+                    std::vector<double> axis_j;
+                    // Footprint of each sensor.
+                    std::vector<geom::Box> boxes;
+                };
+
+                // Layout of a 2D domain of the given sizes.
+                Layout layout(size_t rows, size_t cols);
+
+                // True if this group can combine rows of sensed values, see combine().
+                virtual bool combines() const;
+
+                /** Combine the values sensed on row i of the domain into its cells.
+                 *
+                 * Both cells and the scratch values hold a whole row.
+                 */
+                virtual void combine(const Layout& layout, size_t i, double* cells, double* values);
+
+                /** Evaluate the group on all cells of out, combining rows of sensed values with kernels.
+                 *
+                 * Return false if this group cannot be evaluated this way,
+                 * in which case out is left untouched.
+                 */
+                bool rows(domain::Plan& out, size_t threads);
+
+                // No row evaluation for other domains.
+                template<class D>
+                bool rows(D&, size_t) {return false;}
+
+                /** Call f(cells, values, n) with the n values sensed by each sensor on row i.
+                 *
+                 * If not dense, only the part of the row within the footprint of the sensor is passed,
+                 * which is enough when sensing zero leaves a cell unchanged.
+                 * Otherwise, whole rows are passed, set to zero outside the footprint.
+                 *
+                 * Sensors are visited in order, so that each cell sees its values in the same order
+                 * than sense() would.
+                 */
+                template<class F>
+                void scatter(const Layout& layout, size_t i, double* cells, double* values, F f, bool dense);
+
+                /** Union of the cells where each sensor senses more than threshold, see Detector::detected.
+                 *
+                 * Return false if a sensor cannot compute its cells this way.
+                 */
+                bool unite(domain::Bits& cells, const std::vector<double>& xs, const std::vector<double>& ys, double threshold);
         };
 
         namespace proba {
@@ -54,7 +162,7 @@ namespace ealain {
                     const double _max;
 
                 public:
-                    AtLeastOne(proj::Projection<double,size_t>& p,
+                    AtLeastOne(const proj::Projection<double,size_t>& p,
                             const double proba_min = 0.0, const double proba_max = 1.0) :
                         Group(p),
                         _min(proba_min), _max(proba_max)
@@ -64,7 +172,7 @@ namespace ealain {
                         assert(is_proba(_max));
                     }
 
-                    AtLeastOne(proj::Projection<double,size_t>& p,
+                    AtLeastOne(const proj::Projection<double,size_t>& p,
                             std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors,
                             const double proba_min = 0.0, const double proba_max = 1.0
                         ) :
@@ -78,6 +186,19 @@ namespace ealain {
 
 
                     virtual double sense(const Position& position);
+
+                    // Probability of detection, given the probability of having no detection at all.
+                    double detection(double none) const;
+
+                    // If all the sensors only sense 0 or 1, the group senses detection(0) where any sensor does.
+                    virtual bool binary(domain::Bits& high_cells, double& low, double& high,
+                            const std::vector<double>& xs, const std::vector<double>& ys);
+
+                protected:
+                    virtual bool combines() const {return true;}
+
+                    // Sensors not covering a cell leave its probability of non-detection unchanged.
+                    virtual void combine(const Layout& layout, size_t i, double* cells, double* values);
             };
 
         } // proba
@@ -105,76 +226,109 @@ namespace ealain {
                 const double _init;
                 const Function _func;
 
+                // Row kernel equivalent to _func, if any, set by derived classes.
+                kernel::Row _kernel;
+
+                // True if aggregating a zero leaves the cost unchanged.
+                bool _sparse;
+
             public:
-                Aggregate(proj::Projection<double,size_t>& p,
+                Aggregate(const proj::Projection<double,size_t>& p,
                         const double init, const Function func) :
                     Group(p),
                     _init(init),
-                    _func(func)
+                    _func(func),
+                    _kernel(nullptr),
+                    _sparse(false)
                 { }
 
-                Aggregate(proj::Projection<double,size_t>& p,
+                Aggregate(const proj::Projection<double,size_t>& p,
                         std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors,
                         const double init, const Function func) :
                     Group(p,detectors),
                     _init(init),
-                    _func(func)
+                    _func(func),
+                    _kernel(nullptr),
+                    _sparse(false)
                 {}
 
             protected:
                 virtual double sense(const Position& position);
+
+                // Only groups with a kernel can be evaluated by rows.
+                virtual bool combines() const {return _kernel != nullptr;}
+
+                virtual void combine(const Layout& layout, size_t i, double* cells, double* values);
         };
 
         // Group that add costs of each sensor.
         class Additive : public Aggregate
         {
             public:
-                Additive(proj::Projection<double,size_t>& p, const double init = 0) :
+                Additive(const proj::Projection<double,size_t>& p, const double init = 0) :
                     Aggregate(p,init,std::plus<double>())
-                {}
+                {
+                    _kernel = kernel::sum;
+                    _sparse = true;
+                }
 
-                Additive(proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors, const double init = 0) :
+                Additive(const proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors, const double init = 0) :
                     Aggregate(p,detectors,init,std::plus<double>())
-                {}
+                {
+                    _kernel = kernel::sum;
+                    _sparse = true;
+                }
         };
 
         // Group that multiply costs of each sensor.
         class Multiplicative : public Aggregate
         {
             public:
-                Multiplicative(proj::Projection<double,size_t>& p) :
+                Multiplicative(const proj::Projection<double,size_t>& p) :
                     Aggregate(p,1,std::multiplies<double>())
-                {}
+                {
+                    _kernel = kernel::product;
+                }
 
-                Multiplicative(proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors) :
+                Multiplicative(const proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors) :
                     Aggregate(p,detectors,1,std::multiplies<double>())
-                {}
+                {
+                    _kernel = kernel::product;
+                }
         };
 
         // Group that consider the minimum cost of all sensors.
         class Min : public Aggregate
         {
             public:
-                Min(proj::Projection<double,size_t>& p) :
+                Min(const proj::Projection<double,size_t>& p) :
                     Aggregate(p,std::numeric_limits<double>::max(),std::less<double>())
-                {}
+                {
+                    _kernel = kernel::less;
+                }
 
-                Min(proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors) :
+                Min(const proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors) :
                     Aggregate(p,detectors,std::numeric_limits<double>::max(),std::less<double>())
-                {}
+                {
+                    _kernel = kernel::less;
+                }
         };
 
         // Group that consider the maximum cost of all sensors.
         class Max : public Aggregate
         {
             public:
-                Max(proj::Projection<double,size_t>& p) :
+                Max(const proj::Projection<double,size_t>& p) :
                     Aggregate(p,std::numeric_limits<double>::min(),std::greater<double>())
-                {}
+                {
+                    _kernel = kernel::greater;
+                }
 
-                Max(proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors) :
+                Max(const proj::Projection<double,size_t>& p,std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors) :
                     Aggregate(p,detectors,std::numeric_limits<double>::min(),std::greater<double>())
-                {}
+                {
+                    _kernel = kernel::greater;
+                }
         };
 
         // Group that outputs either one or zeros.
@@ -185,21 +339,32 @@ namespace ealain {
                 double _threshold;
 
             public:
-                Binary(proj::Projection<double,size_t>& p, double threshold = 0) :
+                Binary(const proj::Projection<double,size_t>& p, double threshold = 0) :
                     Group(p),
                     _threshold(threshold)
                 {}
 
-                Binary(proj::Projection<double,size_t>& p, std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors, double threshold = 0) :
+                Binary(const proj::Projection<double,size_t>& p, std::initializer_list<std::reference_wrapper<sensor::Detector>> detectors, double threshold = 0) :
                     Group(p, detectors),
                     _threshold(threshold)
                 {}
 
                 virtual double sense(const Position& position);
+
+                // Senses 1 where any sensor exceeds the threshold.
+                virtual bool binary(domain::Bits& high_cells, double& low, double& high,
+                        const std::vector<double>& xs, const std::vector<double>& ys);
+
+            protected:
+                virtual bool combines() const {return true;}
+
+                // Sensors not covering a cell cannot exceed a non-negative threshold there.
+                virtual void combine(const Layout& layout, size_t i, double* cells, double* values);
         };
 
     } // net
 } // ealain
 
+#include "group.hpp"
 
 #endif // __EALAIN_GROUP_H__
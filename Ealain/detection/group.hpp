@@ -0,0 +1,51 @@
+#include <algorithm>
+
+#include "../utils.h"
+
+namespace ealain {
+namespace group {
+
+    template<class D>
+    D Group::operator()(const D& domain)
+    {
+        D out = domain;
+        this->evaluate(out);
+        return out;
+    }
+
+    template<class D>
+    void Group::evaluate(D& out, size_t threads)
+    {
+        this->prepare();
+        if(not this->rows(out, threads)) {
+            sensor::Detector::evaluate(out, threads);
+        }
+    }
+
+    template<class F>
+    void Group::scatter(const Layout& layout, size_t i, double* cells, double* values, F f, bool dense)
+    {
+        const std::size_t cols = layout.axis_j.size();
+        for(std::size_t s = 0; s < layout.boxes.size(); ++s) {
+            const geom::Box& box = layout.boxes[s];
+            // Columns [begin,end) of this row within the footprint.
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            if(box.row_min <= i and i <= box.row_max and box.col_min < cols) {
+                begin = box.col_min;
+                end = std::min(box.col_max, cols-1) + 1;
+            }
+            if(dense) {
+                std::fill(values, values + begin, 0.0);
+                std::fill(values + end, values + cols, 0.0);
+                this->at(s).get().row(layout.axis_i[i], layout.axis_j.data() + begin, end - begin, values + begin);
+                f(cells, values, cols);
+            } else if(begin < end) {
+                this->at(s).get().row(layout.axis_i[i], layout.axis_j.data() + begin, end - begin, values);
+                f(cells + begin, values, end - begin);
+            }
+        }
+    }
+
+} // group
+} // ealain
@@ -0,0 +1,624 @@
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define EALAIN_KERNEL_X86
+#endif
+
+#include "kernel.h"
+
+namespace ealain {
+namespace kernel {
+
+namespace {
+
+// Scalar versions, the reference.
+
+void complement_product_scalar(double* cells, const double* values, std::size_t n)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        cells[j] = cells[j] * (1 - values[j]);
+    }
+}
+
+void sum_scalar(double* cells, const double* values, std::size_t n)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        cells[j] = cells[j] + values[j];
+    }
+}
+
+void product_scalar(double* cells, const double* values, std::size_t n)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        cells[j] = cells[j] * values[j];
+    }
+}
+
+void less_scalar(double* cells, const double* values, std::size_t n)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        cells[j] = cells[j] < values[j];
+    }
+}
+
+void greater_scalar(double* cells, const double* values, std::size_t n)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        cells[j] = cells[j] > values[j];
+    }
+}
+
+void threshold_scalar(double* cells, const double* values, std::size_t n, double threshold)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        if(values[j] > threshold) {
+            cells[j] = 1;
+        }
+    }
+}
+
+void at_least_one_scalar(double* cells, std::size_t n, double min, double max)
+{
+    for(std::size_t j = 0; j < n; ++j) {
+        double none = cells[j];
+        if(none < 0.0) {
+            none = 0.0;
+        }
+        const double res = 1 - none;
+        if(res < min) {
+            cells[j] = min;
+        } else if(res > max) {
+            cells[j] = max;
+        } else {
+            cells[j] = res;
+        }
+    }
+}
+
+
+// Probability of detection at one position, the reference for falloff.
+inline double falloff_one(double visible, double dx2, double y, double cy, double range, double eps)
+{
+    const double dy = y - cy;
+    const double d = eps + std::sqrt(dx2 + dy * dy);
+    if(visible == 0 or d > range) {
+        return 0;
+    }
+    const double p = (range - d) / range;
+    return p > 1 ? 1 : p;
+}
+
+void falloff_scalar(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    const double dx = x - cx;
+    const double dx2 = dx * dx;
+    for(std::size_t j = 0; j < n; ++j) {
+        values[j] = falloff_one(values[j], dx2, ys[j], cy, range, eps);
+    }
+}
+
+// Detection at one position, the reference for disc.
+inline double disc_one(double visible, double dx2, double y, double cy, double range, double eps)
+{
+    const double dy = y - cy;
+    const double d = eps + std::sqrt(dx2 + dy * dy);
+    return (visible == 0 or d > range) ? 0 : 1;
+}
+
+/** Squared distances below which positions are surely in the disc, and above which they surely are not.
+ *
+ * The margin is large compared to rounding errors, in between, distances are computed.
+ * Returns false if the disc is too small for the margin to be safe.
+ */
+bool disc_bounds(double range, double eps, double& inside, double& outside)
+{
+    const double t = range - eps;
+    if(not (t > range / 2)) {
+        return false;
+    }
+    inside = t * t * (1 - 1e-9);
+    outside = t * t * (1 + 1e-9);
+    return true;
+}
+
+void disc_scalar(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    const double dx = x - cx;
+    const double dx2 = dx * dx;
+    double inside, outside;
+    if(not disc_bounds(range, eps, inside, outside)) {
+        for(std::size_t j = 0; j < n; ++j) {
+            values[j] = disc_one(values[j], dx2, ys[j], cy, range, eps);
+        }
+        return;
+    }
+    for(std::size_t j = 0; j < n; ++j) {
+        const double dy = ys[j] - cy;
+        const double s = dx2 + dy * dy;
+        if(values[j] == 0 or s > outside) {
+            values[j] = 0;
+        } else if(s < inside) {
+            values[j] = 1;
+        } else {
+            values[j] = disc_one(values[j], dx2, ys[j], cy, range, eps);
+        }
+    }
+}
+
+#ifdef EALAIN_KERNEL_X86
+
+// AVX2 versions, 4 cells at a time, the remainder by the scalar version.
+
+__attribute__((target("avx2")))
+void complement_product_avx2(double* cells, const double* values, std::size_t n)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        const __m256d c = _mm256_loadu_pd(cells + j);
+        const __m256d v = _mm256_loadu_pd(values + j);
+        _mm256_storeu_pd(cells + j, _mm256_mul_pd(c, _mm256_sub_pd(one, v)));
+    }
+    complement_product_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void sum_avx2(double* cells, const double* values, std::size_t n)
+{
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(cells + j, _mm256_add_pd(_mm256_loadu_pd(cells + j), _mm256_loadu_pd(values + j)));
+    }
+    sum_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void product_avx2(double* cells, const double* values, std::size_t n)
+{
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        _mm256_storeu_pd(cells + j, _mm256_mul_pd(_mm256_loadu_pd(cells + j), _mm256_loadu_pd(values + j)));
+    }
+    product_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void less_avx2(double* cells, const double* values, std::size_t n)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        const __m256d mask = _mm256_cmp_pd(_mm256_loadu_pd(cells + j), _mm256_loadu_pd(values + j), _CMP_LT_OQ);
+        _mm256_storeu_pd(cells + j, _mm256_and_pd(mask, one));
+    }
+    less_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void greater_avx2(double* cells, const double* values, std::size_t n)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        const __m256d mask = _mm256_cmp_pd(_mm256_loadu_pd(cells + j), _mm256_loadu_pd(values + j), _CMP_GT_OQ);
+        _mm256_storeu_pd(cells + j, _mm256_and_pd(mask, one));
+    }
+    greater_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void threshold_avx2(double* cells, const double* values, std::size_t n, double threshold)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d t = _mm256_set1_pd(threshold);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        const __m256d mask = _mm256_cmp_pd(_mm256_loadu_pd(values + j), t, _CMP_GT_OQ);
+        _mm256_storeu_pd(cells + j, _mm256_blendv_pd(_mm256_loadu_pd(cells + j), one, mask));
+    }
+    threshold_scalar(cells + j, values + j, n - j, threshold);
+}
+
+__attribute__((target("avx2")))
+void at_least_one_avx2(double* cells, std::size_t n, double min, double max)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d lo = _mm256_set1_pd(min);
+    const __m256d hi = _mm256_set1_pd(max);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        __m256d none = _mm256_loadu_pd(cells + j);
+        none = _mm256_blendv_pd(none, zero, _mm256_cmp_pd(none, zero, _CMP_LT_OQ));
+        __m256d res = _mm256_sub_pd(one, none);
+        const __m256d below = _mm256_cmp_pd(res, lo, _CMP_LT_OQ);
+        const __m256d above = _mm256_cmp_pd(res, hi, _CMP_GT_OQ);
+        res = _mm256_blendv_pd(res, hi, above);
+        res = _mm256_blendv_pd(res, lo, below);
+        _mm256_storeu_pd(cells + j, res);
+    }
+    at_least_one_scalar(cells + j, n - j, min, max);
+}
+
+__attribute__((target("avx2")))
+void falloff_avx2(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    const double dx = x - cx;
+    const double dx2 = dx * dx;
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d vdx2 = _mm256_set1_pd(dx2);
+    const __m256d vcy = _mm256_set1_pd(cy);
+    const __m256d vrange = _mm256_set1_pd(range);
+    const __m256d veps = _mm256_set1_pd(eps);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + j), vcy);
+        const __m256d d = _mm256_add_pd(veps, _mm256_sqrt_pd(_mm256_add_pd(vdx2, _mm256_mul_pd(dy, dy))));
+        __m256d p = _mm256_div_pd(_mm256_sub_pd(vrange, d), vrange);
+        p = _mm256_blendv_pd(p, one, _mm256_cmp_pd(p, one, _CMP_GT_OQ));
+        const __m256d seen = _mm256_and_pd(
+                _mm256_cmp_pd(_mm256_loadu_pd(values + j), zero, _CMP_NEQ_UQ),
+                _mm256_cmp_pd(d, vrange, _CMP_NGT_UQ));
+        _mm256_storeu_pd(values + j, _mm256_and_pd(seen, p));
+    }
+    falloff_scalar(values + j, x, ys + j, n - j, cx, cy, range, eps);
+}
+
+__attribute__((target("avx2")))
+void disc_avx2(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    const double dx = x - cx;
+    const double dx2 = dx * dx;
+    double inside, outside;
+    if(not disc_bounds(range, eps, inside, outside)) {
+        disc_scalar(values, x, ys, n, cx, cy, range, eps);
+        return;
+    }
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d vdx2 = _mm256_set1_pd(dx2);
+    const __m256d vcy = _mm256_set1_pd(cy);
+    const __m256d vin = _mm256_set1_pd(inside);
+    const __m256d vout = _mm256_set1_pd(outside);
+    std::size_t j = 0;
+    for(; j + 4 <= n; j += 4) {
+        const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + j), vcy);
+        const __m256d s = _mm256_add_pd(vdx2, _mm256_mul_pd(dy, dy));
+        const __m256d visible = _mm256_cmp_pd(_mm256_loadu_pd(values + j), zero, _CMP_NEQ_UQ);
+        const __m256d in = _mm256_cmp_pd(s, vin, _CMP_LT_OQ);
+        const __m256d out = _mm256_cmp_pd(s, vout, _CMP_GT_OQ);
+        // Visible positions neither surely in nor surely out.
+        const int unsure = _mm256_movemask_pd(_mm256_andnot_pd(_mm256_or_pd(in, out), visible));
+        __m256d result = _mm256_and_pd(_mm256_and_pd(visible, in), one);
+        if(unsure) {
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, result);
+            for(int l = 0; l < 4; ++l) {
+                if(unsure & (1 << l)) {
+                    lanes[l] = disc_one(values[j+l], dx2, ys[j+l], cy, range, eps);
+                }
+            }
+            result = _mm256_load_pd(lanes);
+        }
+        _mm256_storeu_pd(values + j, result);
+    }
+    disc_scalar(values + j, x, ys + j, n - j, cx, cy, range, eps);
+}
+
+// AVX-512 versions, 8 cells at a time.
+
+__attribute__((target("avx512f")))
+void complement_product_avx512(double* cells, const double* values, std::size_t n)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        const __m512d c = _mm512_loadu_pd(cells + j);
+        const __m512d v = _mm512_loadu_pd(values + j);
+        _mm512_storeu_pd(cells + j, _mm512_mul_pd(c, _mm512_sub_pd(one, v)));
+    }
+    complement_product_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx512f")))
+void sum_avx512(double* cells, const double* values, std::size_t n)
+{
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(cells + j, _mm512_add_pd(_mm512_loadu_pd(cells + j), _mm512_loadu_pd(values + j)));
+    }
+    sum_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx512f")))
+void product_avx512(double* cells, const double* values, std::size_t n)
+{
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        _mm512_storeu_pd(cells + j, _mm512_mul_pd(_mm512_loadu_pd(cells + j), _mm512_loadu_pd(values + j)));
+    }
+    product_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx512f")))
+void less_avx512(double* cells, const double* values, std::size_t n)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        const __mmask8 mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(cells + j), _mm512_loadu_pd(values + j), _CMP_LT_OQ);
+        _mm512_storeu_pd(cells + j, _mm512_maskz_mov_pd(mask, one));
+    }
+    less_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx512f")))
+void greater_avx512(double* cells, const double* values, std::size_t n)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        const __mmask8 mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(cells + j), _mm512_loadu_pd(values + j), _CMP_GT_OQ);
+        _mm512_storeu_pd(cells + j, _mm512_maskz_mov_pd(mask, one));
+    }
+    greater_scalar(cells + j, values + j, n - j);
+}
+
+__attribute__((target("avx512f")))
+void threshold_avx512(double* cells, const double* values, std::size_t n, double threshold)
+{
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d t = _mm512_set1_pd(threshold);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        const __mmask8 mask = _mm512_cmp_pd_mask(_mm512_loadu_pd(values + j), t, _CMP_GT_OQ);
+        _mm512_storeu_pd(cells + j, _mm512_mask_mov_pd(_mm512_loadu_pd(cells + j), mask, one));
+    }
+    threshold_scalar(cells + j, values + j, n - j, threshold);
+}
+
+__attribute__((target("avx512f")))
+void at_least_one_avx512(double* cells, std::size_t n, double min, double max)
+{
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d lo = _mm512_set1_pd(min);
+    const __m512d hi = _mm512_set1_pd(max);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        __m512d none = _mm512_loadu_pd(cells + j);
+        none = _mm512_mask_mov_pd(none, _mm512_cmp_pd_mask(none, zero, _CMP_LT_OQ), zero);
+        __m512d res = _mm512_sub_pd(one, none);
+        const __mmask8 below = _mm512_cmp_pd_mask(res, lo, _CMP_LT_OQ);
+        const __mmask8 above = _mm512_cmp_pd_mask(res, hi, _CMP_GT_OQ);
+        res = _mm512_mask_mov_pd(res, above, hi);
+        res = _mm512_mask_mov_pd(res, below, lo);
+        _mm512_storeu_pd(cells + j, res);
+    }
+    at_least_one_scalar(cells + j, n - j, min, max);
+}
+
+// GCC warns that _mm512_sqrt_pd may use its uninitialized pass-through operand,
+// which is never read as the intrinsic computes every lane: a false positive.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+__attribute__((target("avx512f")))
+void falloff_avx512(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    const double dx = x - cx;
+    const double dx2 = dx * dx;
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d vdx2 = _mm512_set1_pd(dx2);
+    const __m512d vcy = _mm512_set1_pd(cy);
+    const __m512d vrange = _mm512_set1_pd(range);
+    const __m512d veps = _mm512_set1_pd(eps);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ys + j), vcy);
+        const __m512d d = _mm512_add_pd(veps, _mm512_sqrt_pd(_mm512_add_pd(vdx2, _mm512_mul_pd(dy, dy))));
+        __m512d p = _mm512_div_pd(_mm512_sub_pd(vrange, d), vrange);
+        p = _mm512_mask_mov_pd(p, _mm512_cmp_pd_mask(p, one, _CMP_GT_OQ), one);
+        const __mmask8 seen = _mm512_cmp_pd_mask(_mm512_loadu_pd(values + j), zero, _CMP_NEQ_UQ)
+                            & _mm512_cmp_pd_mask(d, vrange, _CMP_NGT_UQ);
+        _mm512_storeu_pd(values + j, _mm512_maskz_mov_pd(seen, p));
+    }
+    falloff_scalar(values + j, x, ys + j, n - j, cx, cy, range, eps);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+__attribute__((target("avx512f")))
+void disc_avx512(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    const double dx = x - cx;
+    const double dx2 = dx * dx;
+    double inside, outside;
+    if(not disc_bounds(range, eps, inside, outside)) {
+        disc_scalar(values, x, ys, n, cx, cy, range, eps);
+        return;
+    }
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d vdx2 = _mm512_set1_pd(dx2);
+    const __m512d vcy = _mm512_set1_pd(cy);
+    const __m512d vin = _mm512_set1_pd(inside);
+    const __m512d vout = _mm512_set1_pd(outside);
+    std::size_t j = 0;
+    for(; j + 8 <= n; j += 8) {
+        const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(ys + j), vcy);
+        const __m512d s = _mm512_add_pd(vdx2, _mm512_mul_pd(dy, dy));
+        const __mmask8 visible = _mm512_cmp_pd_mask(_mm512_loadu_pd(values + j), zero, _CMP_NEQ_UQ);
+        const __mmask8 in = _mm512_cmp_pd_mask(s, vin, _CMP_LT_OQ);
+        const __mmask8 out = _mm512_cmp_pd_mask(s, vout, _CMP_GT_OQ);
+        // Visible positions neither surely in nor surely out.
+        const __mmask8 unsure = visible & ~(in | out);
+        if(unsure) {
+            for(int l = 0; l < 8; ++l) {
+                if(unsure & (1 << l)) {
+                    values[j+l] = disc_one(values[j+l], dx2, ys[j+l], cy, range, eps);
+                }
+            }
+        }
+        _mm512_mask_storeu_pd(values + j, static_cast<__mmask8>(~unsure), _mm512_maskz_mov_pd(visible & in, one));
+    }
+    disc_scalar(values + j, x, ys + j, n - j, cx, cy, range, eps);
+}
+
+#endif // EALAIN_KERNEL_X86
+
+// Kernels of one instruction set.
+struct Table
+{
+    ISA set;
+    Row complement_product;
+    Row sum;
+    Row product;
+    Row less;
+    Row greater;
+    void (*threshold)(double*, const double*, std::size_t, double);
+    void (*at_least_one)(double*, std::size_t, double, double);
+    void (*falloff)(double*, double, const double*, std::size_t, double, double, double, double);
+    void (*disc)(double*, double, const double*, std::size_t, double, double, double, double);
+};
+
+const Table scalar_table = {ISA::scalar,
+    complement_product_scalar, sum_scalar, product_scalar, less_scalar, greater_scalar,
+    threshold_scalar, at_least_one_scalar, falloff_scalar, disc_scalar};
+
+#ifdef EALAIN_KERNEL_X86
+const Table avx2_table = {ISA::avx2,
+    complement_product_avx2, sum_avx2, product_avx2, less_avx2, greater_avx2,
+    threshold_avx2, at_least_one_avx2, falloff_avx2, disc_avx2};
+
+const Table avx512_table = {ISA::avx512,
+    complement_product_avx512, sum_avx512, product_avx512, less_avx512, greater_avx512,
+    threshold_avx512, at_least_one_avx512, falloff_avx512, disc_avx512};
+#endif
+
+bool supported(ISA set)
+{
+    switch(set) {
+#ifdef EALAIN_KERNEL_X86
+        case ISA::avx512:
+            return __builtin_cpu_supports("avx512f");
+        case ISA::avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        case ISA::scalar:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const Table* table_of(ISA set)
+{
+    switch(set) {
+#ifdef EALAIN_KERNEL_X86
+        case ISA::avx512:
+            return &avx512_table;
+        case ISA::avx2:
+            return &avx2_table;
+#endif
+        default:
+            return &scalar_table;
+    }
+}
+
+// Kernels in use, the widest supported by default.
+const Table*& current()
+{
+    static const Table* table = table_of(best());
+    return table;
+}
+
+} // anonymous
+
+ISA best()
+{
+    for(ISA set : {ISA::avx512, ISA::avx2}) {
+        if(supported(set)) {
+            return set;
+        }
+    }
+    return ISA::scalar;
+}
+
+ISA isa()
+{
+    return current()->set;
+}
+
+bool isa(ISA set)
+{
+    if(not supported(set)) {
+        return false;
+    }
+    current() = table_of(set);
+    return true;
+}
+
+void complement_product(double* cells, const double* values, std::size_t n)
+{
+    current()->complement_product(cells, values, n);
+}
+
+void sum(double* cells, const double* values, std::size_t n)
+{
+    current()->sum(cells, values, n);
+}
+
+void product(double* cells, const double* values, std::size_t n)
+{
+    current()->product(cells, values, n);
+}
+
+void less(double* cells, const double* values, std::size_t n)
+{
+    current()->less(cells, values, n);
+}
+
+void greater(double* cells, const double* values, std::size_t n)
+{
+    current()->greater(cells, values, n);
+}
+
+void threshold(double* cells, const double* values, std::size_t n, double threshold)
+{
+    current()->threshold(cells, values, n, threshold);
+}
+
+void at_least_one(double* cells, std::size_t n, double min, double max)
+{
+    assert(min < max);
+    current()->at_least_one(cells, n, min, max);
+}
+
+void falloff(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    current()->falloff(values, x, ys, n, cx, cy, range, eps);
+}
+
+void disc(double* values, double x, const double* ys, std::size_t n,
+        double cx, double cy, double range, double eps)
+{
+    current()->disc(values, x, ys, n, cx, cy, range, eps);
+}
+
+} // kernel
+} // ealain
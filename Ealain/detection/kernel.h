@@ -0,0 +1,80 @@
+#ifndef __EALAIN_KERNEL_H__
+#define __EALAIN_KERNEL_H__
+
+#include <cstddef>
+
+namespace ealain {
+
+    /** Data-parallel kernels combining rows of sensed values into rows of cells.
+     *
+     * Each kernel has a scalar, an AVX2 and an AVX-512 version,
+     * the widest one supported by the processor being selected at run time.
+     * All the versions compute exactly the same results as the scalar one.
+     */
+    namespace kernel {
+
+        // Instruction sets the kernels can use.
+        enum class ISA {
+            scalar,
+            avx2,
+            avx512
+        };
+
+        // Instruction set currently used.
+        ISA isa();
+
+        // Use the given instruction set, returns false (and changes nothing) if the processor does not support it.
+        bool isa(ISA set);
+
+        // Widest instruction set supported by the processor.
+        ISA best();
+
+        // Row kernel signature: combine n values into n cells.
+        using Row = void(*)(double* cells, const double* values, std::size_t n);
+
+        // cells = cells × (1 - values), probability of having no detection.
+        void complement_product(double* cells, const double* values, std::size_t n);
+
+        // cells = cells + values
+        void sum(double* cells, const double* values, std::size_t n);
+
+        // cells = cells × values
+        void product(double* cells, const double* values, std::size_t n);
+
+        // cells = cells < values, as in std::less.
+        void less(double* cells, const double* values, std::size_t n);
+
+        // cells = cells > values, as in std::greater.
+        void greater(double* cells, const double* values, std::size_t n);
+
+        // cells = 1 where values > threshold, unchanged elsewhere.
+        void threshold(double* cells, const double* values, std::size_t n, double threshold);
+
+        /** Turn probabilities of no detection into probabilities of at least one detection,
+         * clamped to [min,max], as in group::proba::AtLeastOne::detection.
+         */
+        void at_least_one(double* cells, std::size_t n, double min, double max);
+
+        /** Probabilities of detection along a row, decreasing linearly with the distance to a camera.
+         *
+         * Positions are (x, ys[k]), the camera is at (cx,cy), and d = eps + distance.
+         * values holds the visibility (0 or 1) of each position on input,
+         * and on output, (range - d)/range if visible and d <= range, 0 otherwise,
+         * as in camera::Omnidir.
+         */
+        void falloff(double* values, double x, const double* ys, std::size_t n,
+                double cx, double cy, double range, double eps);
+
+        /** Same as falloff, but 1 if visible and d <= range, as in camera::Omnibinary.
+         *
+         * Compares squared distances, only computing the distance itself
+         * for the few positions too close to the boundary of the disc to decide otherwise.
+         */
+        void disc(double* values, double x, const double* ys, std::size_t n,
+                double cx, double cy, double range, double eps);
+
+    } // kernel
+
+} // ealain
+
+#endif // __EALAIN_KERNEL_H__
@@ -13,12 +13,38 @@ double Detector::operator()(const Position& position)
     return this->sense(position);
 }
 
+void Detector::row(double x, const double* ys, size_t n, double* values)
+{
+    this->sense_row(x, ys, n, values);
+}
+
+bool Detector::detected(domain::Bits&, geom::Box&, const std::vector<double>&, const std::vector<double>&, double)
+{
+    return false;
+}
+
+void Detector::sense_row(double x, const double* ys, size_t n, double* values)
+{
+    Position position = {x, 0};
+    for(size_t j = 0; j < n; ++j) {
+        position[1] = ys[j];
+        values[j] = this->sense(position);
+    }
+}
 
 const proj::Projection<double,size_t>& Detector::projection() const
 {
     return _proj;
 }
 
+geom::Box Detector::footprint()
+{
+    assert(_proj.size() >= 2);
+    return geom::Box{
+        _proj[0].range_idx().min(), _proj[1].range_idx().min(),
+        _proj[0].range_idx().max(), _proj[1].range_idx().max()};
+}
+
 std::vector<double> Detector::proj(std::vector<size_t> x) const
 {
     return _proj(x);
@@ -28,14 +28,56 @@ namespace ealain {
                 // Compute a cost for a normalized position.
                 double operator()(const Position& pos);
 
+                /** Compute the costs of n positions of a 2D domain sharing their first coordinate.
+                 *
+                 * x first numerical coordinate of all the positions.
+                 * ys second numerical coordinate of each position.
+                 * values n computed costs.
+                 */
+                void row(double x, const double* ys, size_t n, double* values);
+
                 // Call this detector on all cells of the given domain.
                 template<class D>
                 D operator()(const D& domain);
 
+                /** Call this detector on all cells of out, overwriting them in place.
+                 *
+                 * Rows are split in tiles across the given number of threads (0 for the hardware concurrency).
+                 * Each cell being computed independently, the result does not depend on the number of threads.
+                 */
+                template<class D>
+                void evaluate(D& out, size_t threads = 1);
+
+                /** Compute whatever sense() lazily builds, so that it can then be called concurrently.
+                 *
+                 * Called before evaluating a whole domain.
+                 */
+                virtual void prepare() {}
+
                 Detector(const proj::Projection<double,size_t>& p) : _proj(p) {};
 
                 const proj::Projection<double,size_t>& projection() const;
 
+                /** Bounding box of the cells of a 2D domain where this detector may sense something.
+                 *
+                 * Outside of it, sensing is guaranteed to return zero.
+                 * Defaults to the whole indexed space of the projection.
+                 */
+                virtual geom::Box footprint();
+
+                /** Bit-packed cells of a 2D domain where this detector senses more than threshold (non-negative).
+                 *
+                 * xs and ys are the numerical coordinates of the rows and columns of the domain.
+                 * On return, box is the part of the footprint within the domain,
+                 * and cells covers it: cell (i,j) of the domain is at (i-box.row_min, j-box.col_min).
+                 * Nothing exceeds the threshold outside of box.
+                 *
+                 * Return false (the default) if the detector cannot compute its cells this way,
+                 * leaving cells and box unspecified.
+                 */
+                virtual bool detected(domain::Bits& cells, geom::Box& box,
+                        const std::vector<double>& xs, const std::vector<double>& ys, double threshold);
+
                 // Set of proxies toward Projection's interface
                 std::vector<double> proj(std::vector<size_t> x) const;
                 std::vector<size_t> proj(std::vector<double> x) const;
@@ -47,6 +89,9 @@ namespace ealain {
             protected:
                 // Internal interface to be implemented by subclasses.
                 virtual double sense(const Position& pos) = 0;
+
+                // Internal row interface, may be specialized by subclasses, defaults to calling sense on each position.
+                virtual void sense_row(double x, const double* ys, size_t n, double* values);
         };
 
 
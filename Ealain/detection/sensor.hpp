@@ -1,3 +1,7 @@
+#include <algorithm>
+
+#include "../utils.h"
+#include "../trace.h"
 #include "../map/projection.h"
 
 namespace ealain {
@@ -6,21 +10,51 @@ namespace sensor {
     template<class D>
     D Detector::operator()(const D& domain)
     {
-        assert(domain.dimension == _proj.size());
         D out = domain;
-        for(auto it=ealain::begin(out); it != ealain::end(out); ++it) {
-            std::vector<size_t> position_discr;
-            std::vector<double> position_num;
-            position_discr.reserve(domain.dimension);
-            position_num.reserve(domain.dimension);
-            for(std::size_t d = 0; d < domain.dimension; ++d) {
-                position_discr.push_back(it(d));
-            }
-            position_num = _proj(position_discr);
-            *it = this->sense(position_num);
-        }
+        this->evaluate(out);
         return out;
     }
 
+    template<class D>
+    void Detector::evaluate(D& out, size_t threads)
+    {
+        assert(out.dimension == _proj.size());
+        EALAIN_TRACE(sense, out.buffer().size());
+        this->prepare();
+
+        // Numerical coordinates of each index, computed once per axis.
+        std::vector<std::vector<double>> axes;
+        axes.reserve(out.dimension);
+        for(std::size_t d = 0; d < out.dimension; ++d) {
+            axes.push_back(_proj.axis(d, out.box_size(d)));
+        }
+
+        const auto sizes = out.buffer().sizes();
+        const std::size_t stride = out.buffer().strides()[0];
+        parallel_tiles(sizes[0], threads, [&](std::size_t first, std::size_t last) {
+            // Reused across cells, so that sensing does not allocate.
+            Position position_num(sizes.size());
+            auto coords = sizes;
+            std::fill(std::begin(coords), std::end(coords), 0);
+            coords[0] = first;
+
+            double* cell = out.buffer().data() + first * stride;
+            for(std::size_t n = (last - first) * stride; n > 0; --n, ++cell) {
+                for(std::size_t d = 0; d < sizes.size(); ++d) {
+                    position_num[d] = axes[d][coords[d]];
+                }
+                *cell = this->sense(position_num);
+
+                // Next cell in row-major order.
+                for(std::size_t d = sizes.size(); d-- > 0;) {
+                    if(++coords[d] < sizes[d] or d == 0) {
+                        break;
+                    }
+                    coords[d] = 0;
+                }
+            }
+        });
+    }
+
 } // sensor
 } // ealain
@@ -1,7 +1,12 @@
 #include <tuple>
+#include <array>
+#include <cmath>
+#include <algorithm>
 
 #include "../map/geom.h"
+#include "../map/geometry.h"
 #include "../utils.h"
+#include "../trace.h"
 #include "sensor.h"
 #include "situated.h"
 
@@ -10,27 +15,79 @@ namespace sensor {
 
 void Situated::update()
 {
-
-    // Set _visibility to zero, then compute visibility_map with overwrite = false
-    for( auto& v : _visibility.data()) {
-        std::fill(ALL(v), 0);
-    }
+    EALAIN_TRACE(update, 0);
 
     std::vector<double> xy = {static_cast<double>(x),static_cast<double>(y)};
+    std::vector<size_t> ij;
+    _box = whole();
     if (!_bit)
     {
-        std::vector<size_t> ij = _proj(xy);
-        geom::visibility_map_2D_ray_tracing(_visibility.data(),_map,  ij[0], ij[1], false);
+        ij = _proj(xy);
+
+        // Bounding box of the visibility disc.
+        if(std::isfinite(_radius)) {
+            std::array<size_t*,2> mins = {&_box.row_min, &_box.col_min};
+            std::array<size_t*,2> maxs = {&_box.row_max, &_box.col_max};
+            for(size_t d=0; d < 2; ++d) {
+                const auto& range = _proj[d].range_irl();
+                const double lo = std::min(std::max(xy[d] - _radius, range.min()), range.max());
+                const double hi = std::max(std::min(xy[d] + _radius, range.max()), range.min());
+                size_t idx_lo = _proj[d](lo);
+                size_t idx_hi = _proj[d](hi);
+                if(idx_lo > idx_hi) {
+                    std::swap(idx_lo, idx_hi);
+                }
+                // One pixel of margin, because the projection truncates.
+                *mins[d] = std::max(*mins[d], idx_lo > 0 ? idx_lo-1 : 0);
+                *maxs[d] = std::min(*maxs[d], idx_hi+1);
+            }
+        }
     }
     else
     {
-        geom::visibility_map_2D_ray_tracing(_visibility.data(),_map,  xy[0], xy[1], false);
+        // In bitstring mode, the position is already a pixel,
+        // and is not comparable to a real-world radius.
+        ij = {static_cast<size_t>(xy[0]), static_cast<size_t>(xy[1])};
     }
 
+    // Both pixel engines give the same maps, but ray tracing casts one ray per pixel of the map border,
+    // whereas the cost of the sweep is bounded by the box.
+    // Without a wall geometry, the analytic engine also falls back to the sweep of the pixel walls.
+    const bool geometric = _engine == geom::Visibility::analytic and _instance and _instance->geometry();
+    geom::Visibility engine = _engine;
+    if((engine == geom::Visibility::analytic and not geometric)
+       or (engine == geom::Visibility::ray_tracing and std::isfinite(_radius))) {
+        engine = geom::Visibility::sweep;
+    }
+
+    EALAIN_TRACE_CELLS(_box.rows() * _box.cols());
+    if(_cache) {
+        _visibility = (*_cache)(ij[0], ij[1], _box);
+    } else {
+        EALAIN_TRACE(visibility, _box.rows() * _box.cols());
+        auto visibles = std::make_shared<domain::Bits>(_box.rows(), _box.cols());
+        if(_index) {
+            _index->fill(*visibles, ij[0], ij[1], _box);
+        } else if(geometric) {
+            geom::visibility_map_2D(*visibles, *_instance->geometry(), _instance->projection(), ij[0], ij[1], _box);
+        } else if(_instance) {
+            geom::visibility_map_2D(*visibles, _instance->walls(), ij[0], ij[1], _box, engine);
+        } else {
+            geom::visibility_map_2D(*visibles, *_map, ij[0], ij[1], _box, engine);
+        }
+        _visibility = visibles;
+    }
 
     _has_visibility = true;
 }
 
+void Situated::prepare()
+{
+    if(not _has_visibility) {
+        update();
+    }
+}
+
 double Situated::sense(const Position& position)
 {
     assert(position.size() >= 2);
@@ -38,23 +95,103 @@ double Situated::sense(const Position& position)
         update();
     }
 
-    std::vector<double> xy = {position[0],position[1]};
-    std::vector<size_t> ij = _proj(xy);
+    const std::array<size_t,2> ij = _proj(std::array<double,2>{position[0],position[1]});
+
+    if(not _box.contains(ij[0], ij[1])) {
+        return 0;
+    }
+    return (*_visibility)(ij[0] - _box.row_min, ij[1] - _box.col_min);
+}
+
+void Situated::sense_row(double x, const double* ys, size_t n, double* values)
+{
+    if(not _has_visibility) {
+        update();
+    }
+
+    const size_t i = _proj.idx(0, x);
+    if(not _box.contains(i, _box.col_min)) {
+        std::fill(values, values + n, 0.0);
+        return;
+    }
+    const domain::Bits::Word* row = _visibility->row(i - _box.row_min);
+    for(size_t k = 0; k < n; ++k) {
+        const size_t j = _proj.idx(1, ys[k]);
+        if(_box.contains(i, j)) {
+            const size_t c = j - _box.col_min;
+            values[k] = (row[c / domain::Bits::word_bits] >> (c % domain::Bits::word_bits)) & 1;
+        } else {
+            values[k] = 0;
+        }
+    }
+}
 
-    return _visibility[ij];
+const domain::Bits& Situated::visibility()
+{
+    if( not _has_visibility) {
+        update();
+    }
+    return *_visibility;
 }
 
-const domain::PlanT<char>& Situated::visibility()
+const geom::Box& Situated::box()
 {
     if( not _has_visibility) {
         update();
     }
-    return _visibility;
+    return _box;
+}
+
+geom::Box Situated::footprint()
+{
+    return box();
+}
+
+void Situated::radius(double r)
+{
+    assert(r >= 0);
+    _radius = r;
+    _has_visibility = false;
+}
+
+double Situated::radius() const
+{
+    return _radius;
+}
+
+void Situated::engine(geom::Visibility algorithm)
+{
+    _engine = algorithm;
+    _has_visibility = false;
+}
+
+geom::Visibility Situated::engine() const
+{
+    return _engine;
+}
+
+void Situated::cache(geom::VisibilityCache* cache)
+{
+    assert(not cache or (cache->walls().rows() == whole().rows() and cache->walls().cols() == whole().cols()));
+    _cache = cache;
+    _has_visibility = false;
+}
+
+void Situated::index(const geom::VisibilityIndex* index)
+{
+    assert(not index or (index->rows() == whole().rows() and index->cols() == whole().cols()));
+    _index = index;
+    _has_visibility = false;
 }
 
 const inst::Map& Situated::map() const
 {
-    return _map;
+    return _instance ? _instance->map() : *_map;
+}
+
+geom::Box Situated::whole() const
+{
+    return _instance ? geom::whole(_instance->walls()) : geom::whole(*_map);
 }
 
 } // sensor
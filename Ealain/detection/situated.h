@@ -4,11 +4,16 @@
 #include <cmath>
 #include <map>
 #include <functional>
+#include <limits>
 
 #include <cassert>
 #include "../map/plan.h"
+#include "../map/bits.h"
 #include "../map/geom.h"
+#include "../map/cache.h"
+#include "../map/index.h"
 #include "../map/instance.h"
+#include "../map/shared.h"
 #include "../map/projection.h"
 
 namespace ealain {
@@ -22,13 +27,32 @@ namespace ealain {
                 // Cache flag.
                 bool _has_visibility;
 
-                // Note: do not use `bool` because the STL's specialized vector of bool cannot return reference to items.
-                domain::PlanT<char> _visibility;
+                // Bit-packed, only covers _box, may be shared with other sensors through _cache.
+                geom::VisibilityCache::Map _visibility;
 
-                const inst::Map& _map;
+                // Pixels covered by the visibility map cache.
+                geom::Box _box;
+
+                // Distance beyond which nothing needs to be seen, in real-world units.
+                double _radius;
+
+                // Map of the sensor, nullptr if built from a shared instance, which walls are used instead.
+                const inst::Map* _map;
+
+                // Keeps the instance alive, if built from a shared one.
+                inst::Shared _instance;
 
                 bool _bit;
 
+                // Algorithm used to compute the visibility map.
+                geom::Visibility _engine;
+
+                // Shared visibility maps, if any.
+                geom::VisibilityCache* _cache;
+
+                // Precomputed visibility maps, if any.
+                const geom::VisibilityIndex* _index;
+
             public:
                 double x;
                 double y;
@@ -38,10 +62,14 @@ namespace ealain {
                         const proj::Projection<double,size_t>& p
                     ) :
                     Sensor<2>(p),
-                    _map(map),
                     _has_visibility(false),
+                    _box(geom::whole(map)),
+                    _radius(std::numeric_limits<double>::infinity()),
+                    _map(&map),
                     _bit(false),
-                    _visibility(p[0].range_idx().max()+1, p[1].range_idx().max()+1, 0)
+                    _engine(geom::Visibility::ray_tracing),
+                    _cache(nullptr),
+                    _index(nullptr)
                 {}
 
                 Situated(
@@ -52,10 +80,14 @@ namespace ealain {
                         const double y_
                     ) :
                     Sensor<2>(p),
-                    _map(map),
                     _has_visibility(false),
+                    _box(geom::whole(map)),
+                    _radius(std::numeric_limits<double>::infinity()),
+                    _map(&map),
                     _bit(bit),
-                    _visibility(p[0].range_idx().max()+1, p[1].range_idx().max()+1, 0),
+                    _engine(geom::Visibility::ray_tracing),
+                    _cache(nullptr),
+                    _index(nullptr),
                     x(x_),
                     y(y_)
                 {}
@@ -67,24 +99,112 @@ namespace ealain {
                         const double y_
                     ) :
                     Sensor<2>(p),
-                    _map(map),
                     _has_visibility(false),
+                    _box(geom::whole(map)),
+                    _radius(std::numeric_limits<double>::infinity()),
+                    _map(&map),
                     _bit(false),
-                    _visibility(p[0].range_idx().max()+1, p[1].range_idx().max()+1, 0),
+                    _engine(geom::Visibility::ray_tracing),
+                    _cache(nullptr),
+                    _index(nullptr),
                     x(x_),
                     y(y_)
                 {}
 
+                /** Sensor on a shared instance, which it keeps alive.
+                 *
+                 * Visibility maps come from the cache of the instance, if any.
+                 */
+                Situated(const inst::Shared& instance) :
+                    Sensor<2>(instance->projection()),
+                    _has_visibility(false),
+                    _box(geom::whole(instance->walls())),
+                    _radius(std::numeric_limits<double>::infinity()),
+                    _map(nullptr),
+                    _instance(instance),
+                    _bit(false),
+                    _engine(geom::Visibility::ray_tracing),
+                    _cache(instance->cache()),
+                    _index(nullptr)
+                {}
+
+                Situated(const inst::Shared& instance, const double x_, const double y_) :
+                    Situated(instance)
+                {
+                    x = x_;
+                    y = y_;
+                }
+
                 // Internal interface implemented by this subclass.
                 virtual double sense(const Position& position);
 
-                // Return the current visibility map cache.
-                const domain::PlanT<char>& visibility();
+                // Visibility (0 or 1) along a row, read straight from the visibility map.
+                virtual void sense_row(double x, const double* ys, size_t n, double* values);
+
+                /** Return the current visibility map cache.
+                 *
+                 * It only covers the pixels of box():
+                 * pixel (i,j) of the map is at (i-box().row_min, j-box().col_min).
+                 */
+                const domain::Bits& visibility();
+
+                // Pixels covered by the visibility map, nothing is seen outside.
+                const geom::Box& box();
+
+                // Same as box().
+                virtual geom::Box footprint();
 
                 // Update the internal visibility map cache.
                 void update();
 
+                // Update the visibility map cache if it is not valid.
+                virtual void prepare();
+
+                /** Select the algorithm computing the visibility map, invalidates the cache.
+                 *
+                 * The analytic one needs a shared instance built from a wall geometry,
+                 * the pixel walls are swept otherwise.
+                 */
+                void engine(geom::Visibility algorithm);
+
+                // Algorithm currently computing the visibility map.
+                geom::Visibility engine() const;
+
+                /** Limit the visibility map to the pixels closer than the given distance (in real-world units).
+                 *
+                 * Visibility is then only computed and stored within the bounding box of that disc,
+                 * and the sensor sees nothing outside of it.
+                 * The ray tracing engine is then replaced by the sweep, which gives the same maps at a cost bounded by the box.
+                 * Infinity (the default) means the whole map.
+                 * Invalidates the cache.
+                 */
+                void radius(double r);
+
+                // Current maximum distance of visibility.
+                double radius() const;
+
+                /** Get visibility maps from the given cache instead of computing them, invalidates the cache flag.
+                 *
+                 * The cache should be built on the same map and outlive this sensor.
+                 * Its own engine is then used.
+                 * Pass nullptr to compute visibility maps again.
+                 */
+                void cache(geom::VisibilityCache* cache);
+
+                /** Read visibility maps from the given precomputed index instead of computing them, invalidates the cache flag.
+                 *
+                 * The index should be built on the same map and outlive this sensor.
+                 * A cache, if any, takes precedence.
+                 * Pass nullptr to compute visibility maps again.
+                 */
+                void index(const geom::VisibilityIndex* index);
+
+                // Map of the sensor, the dense map of the instance if built from a shared one.
                 const inst::Map& map() const;
+
+            protected:
+                // Pixels of the whole map.
+                geom::Box whole() const;
         };
 
     } // sensor
@@ -15,7 +15,21 @@ void csv(const domain::Domain<2,T>& domain, std::ostream& out,
         std::size_t row, std::size_t col,
         std::size_t width, std::size_t height)
 {
-    csv(domain.data(), out, row, col, width, height);
+    const auto& cells = domain.buffer();
+    if(width==0) {
+        width = cells.sizes()[0];
+    }
+    if(height==0) {
+        height = cells.sizes()[1];
+    }
+
+    out << "i,j,value" << std::endl;
+    for(auto i=row; i < row+width; ++i) {
+        const T* line = cells.data() + cells.offset({i,0});
+        for(auto j=col; j < col+height; ++j) {
+            out << i << "," << j << "," << line[j] << std::endl;
+        } //col
+    } // row
 }
 
 template<typename T>
@@ -23,7 +37,26 @@ void csv(const domain::Domain<3,T>& domain, std::ostream& out,
         std::size_t row, std::size_t col, std::size_t frame,
         std::size_t width, std::size_t height, std::size_t depth)
 {
-    csv(domain.data(), out, row, col, frame, width, height, depth);
+    const auto& cells = domain.buffer();
+    if(width==0) {
+        width = cells.sizes()[0];
+    }
+    if(height==0) {
+        height = cells.sizes()[1];
+    }
+    if(depth==0) {
+        depth = cells.sizes()[2];
+    }
+
+    out << "i,j,k,value" << std::endl;
+    for(auto i=row; i < row+width; ++i) {
+        for(auto j=col; j < col+height; ++j) {
+            const T* line = cells.data() + cells.offset({i,j,0});
+            for(auto k=frame; k < frame+depth; ++k) {
+                out << i << "," << j << "," << k << "," << line[k] << std::endl;
+            } //col
+        } // row
+    } // frame
 }
 
 template<class T>
@@ -98,14 +131,29 @@ void raw(const domain::Domain<DIM,T>& domain, std::string fname,
         std::size_t row, std::size_t col, std::size_t width, std::size_t height)
 {
     // DBGLOG("raw fname " << DIM << "D");
-    raw(domain.data(), fname, row, col, width, height);
+    auto fd = std::fstream(fname.c_str(), std::ios::out | std::ios::binary);
+    raw(domain, fd, row, col, width, height);
+    fd.close();
 }
 
 template<std::size_t DIM, typename T>
 void raw(const domain::Domain<DIM,T>& domain, std::fstream& out,
         std::size_t row, std::size_t col, std::size_t width, std::size_t height)
 {
-    raw(domain.data(), out, row, col, width, height);
+    const auto data = domain.data();
+    if(width==0) {
+        width = data.size();
+    }
+    if(height==0) {
+        assert(data.size()>0);
+        height = data.at(0).size();
+    }
+
+    // Rows are contiguous, write them as a whole.
+    for(auto i=row; i < row+width; ++i) {
+        const T* first = &data[i][col];
+        out.write(reinterpret_cast<const char*>(first), height * sizeof(T));
+    }
 }
 
 
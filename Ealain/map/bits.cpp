@@ -0,0 +1,143 @@
+#include <algorithm>
+
+#include "bits.h"
+
+namespace ealain {
+namespace domain {
+
+// Number of set bits of a word.
+static std::size_t popcount(Bits::Word w)
+{
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    std::size_t n = 0;
+    for(; w; w &= w - 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+Bits::Bits() : Bits(0, 0)
+{}
+
+Bits::Bits(std::size_t rows, std::size_t cols, bool fill) :
+    _rows(rows),
+    _cols(cols),
+    _words((cols + word_bits - 1) / word_bits),
+    _bits(rows * _words, fill ? ~Word(0) : Word(0))
+{
+    if(fill) {
+        trim();
+    }
+}
+
+Bits::Bits(const PlanT<char>& plan) :
+    Bits(plan.sizes()[0], plan.sizes()[1])
+{
+    const char* cell = plan.buffer().data();
+    for(std::size_t i = 0; i < _rows; ++i) {
+        Word* words = row(i);
+        for(std::size_t j = 0; j < _cols; ++j, ++cell) {
+            if(*cell != 0) {
+                words[j / word_bits] |= Word(1) << (j % word_bits);
+            }
+        }
+    }
+}
+
+void Bits::trim()
+{
+    const std::size_t used = _cols % word_bits;
+    if(used == 0) {
+        return;
+    }
+    const Word mask = (Word(1) << used) - 1;
+    for(std::size_t i = 0; i < _rows; ++i) {
+        row(i)[_words - 1] &= mask;
+    }
+}
+
+void Bits::fill(bool value)
+{
+    std::fill(std::begin(_bits), std::end(_bits), value ? ~Word(0) : Word(0));
+    if(value) {
+        trim();
+    }
+}
+
+void Bits::set(std::size_t i, std::size_t first, std::size_t last)
+{
+    assert(i < _rows and first <= last and last <= _cols);
+    Word* words = row(i);
+    while(first < last) {
+        const std::size_t bit = first % word_bits;
+        const std::size_t n = std::min(word_bits - bit, last - first);
+        const Word mask = n == word_bits ? ~Word(0) : ((Word(1) << n) - 1) << bit;
+        words[first / word_bits] |= mask;
+        first += n;
+    }
+}
+
+std::size_t Bits::count() const
+{
+    std::size_t n = 0;
+    for(Word w : _bits) {
+        n += popcount(w);
+    }
+    return n;
+}
+
+void Bits::expand(std::size_t i, double* values) const
+{
+    const Word* words = row(i);
+    for(std::size_t j = 0; j < _cols; ++j) {
+        values[j] = (words[j / word_bits] >> (j % word_bits)) & 1;
+    }
+}
+
+Bits& Bits::operator|=(const Bits& other)
+{
+    assert(_rows == other._rows and _cols == other._cols);
+    for(std::size_t w = 0; w < _bits.size(); ++w) {
+        _bits[w] |= other._bits[w];
+    }
+    return *this;
+}
+
+Bits& Bits::operator&=(const Bits& other)
+{
+    assert(_rows == other._rows and _cols == other._cols);
+    for(std::size_t w = 0; w < _bits.size(); ++w) {
+        _bits[w] &= other._bits[w];
+    }
+    return *this;
+}
+
+void Bits::merge(const Bits& other, std::size_t row_first, std::size_t col_first)
+{
+    assert(row_first + other._rows <= _rows);
+    assert(col_first + other._cols <= _cols);
+    const std::size_t offset = col_first / word_bits;
+    const std::size_t shift = col_first % word_bits;
+    for(std::size_t i = 0; i < other._rows; ++i) {
+        const Word* from = other.row(i);
+        Word* to = row(row_first + i) + offset;
+        for(std::size_t w = 0; w < other._words; ++w) {
+            to[w] |= from[w] << shift;
+            // Padding bits of other are zero, so nothing spills out of the row.
+            if(shift > 0 and offset + w + 1 < _words) {
+                to[w+1] |= from[w] >> (word_bits - shift);
+            }
+        }
+    }
+}
+
+bool Bits::operator==(const Bits& other) const
+{
+    return _rows == other._rows and _cols == other._cols and _bits == other._bits;
+}
+
+} // domain
+} // ealain
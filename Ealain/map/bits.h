@@ -0,0 +1,112 @@
+#ifndef __EALAIN_BITS_H__
+#define __EALAIN_BITS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <cassert>
+#include "buffer.h"
+#include "plan.h"
+
+namespace ealain {
+
+    namespace domain {
+
+        /** Bit-packed 2D grid of booleans, e.g. visibility maps or walls occupancy.
+         *
+         * Cells are stored in row-major order, one bit per cell, 64 cells per word.
+         * Each row starts on a new word, and the padding bits at the end of rows are always zero,
+         * so that whole-word operations (counting, union, intersection) need no masking.
+         */
+        class Bits
+        {
+            public:
+                using Word = std::uint64_t;
+
+                // Number of cells per word.
+                static const std::size_t word_bits = 64;
+
+            protected:
+                std::size_t _rows;
+                std::size_t _cols;
+                // Words per row.
+                std::size_t _words;
+                std::vector<Word,Aligned<Word>> _bits;
+
+                // Zero the padding bits of each row.
+                void trim();
+
+            public:
+                // Empty grid.
+                Bits();
+
+                // Grid of the given sizes, all the cells set to fill.
+                Bits(std::size_t rows, std::size_t cols, bool fill = false);
+
+                // Pack a grid of chars, non-zero cells being set.
+                explicit Bits(const PlanT<char>& plan);
+
+                std::size_t rows() const {return _rows;}
+                std::size_t cols() const {return _cols;}
+
+                // Number of words of each row.
+                std::size_t words() const {return _words;}
+
+                // Bytes used by the cells.
+                std::size_t memory() const {return _bits.size() * sizeof(Word);}
+
+                // Accessor to a cell.
+                bool operator()(std::size_t i, std::size_t j) const
+                {
+                    assert(i < _rows and j < _cols);
+                    return (_bits[i * _words + j / word_bits] >> (j % word_bits)) & 1;
+                }
+
+                void set(std::size_t i, std::size_t j)
+                {
+                    assert(i < _rows and j < _cols);
+                    _bits[i * _words + j / word_bits] |= Word(1) << (j % word_bits);
+                }
+
+                void reset(std::size_t i, std::size_t j)
+                {
+                    assert(i < _rows and j < _cols);
+                    _bits[i * _words + j / word_bits] &= ~(Word(1) << (j % word_bits));
+                }
+
+                // Words of the given row, cell j being bit j%64 of word j/64.
+                Word* row(std::size_t i) {assert(i < _rows); return _bits.data() + i * _words;}
+                const Word* row(std::size_t i) const {assert(i < _rows); return _bits.data() + i * _words;}
+
+                // Set all the cells to the given value.
+                void fill(bool value);
+
+                // Set cells [first,last) of row i, word by word.
+                void set(std::size_t i, std::size_t first, std::size_t last);
+
+                // Number of set cells.
+                std::size_t count() const;
+
+                // Cells of row i as 0 or 1, in values[0…cols()-1].
+                void expand(std::size_t i, double* values) const;
+
+                // Cell-wise union and intersection with a grid of the same sizes.
+                Bits& operator|=(const Bits& other);
+                Bits& operator&=(const Bits& other);
+
+                /** Union with a smaller grid placed with its first cell at (row,col).
+                 *
+                 * other should fit within this grid.
+                 */
+                void merge(const Bits& other, std::size_t row, std::size_t col);
+
+                bool operator==(const Bits& other) const;
+                bool operator!=(const Bits& other) const {return not (*this == other);}
+        };
+
+    } // domain
+
+} // ealain
+
+#endif // __EALAIN_BITS_H__
@@ -0,0 +1,209 @@
+#ifndef __EALAIN_BUFFER_H__
+#define __EALAIN_BUFFER_H__
+
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <iterator>
+
+#include <cassert>
+
+namespace ealain {
+
+    namespace domain {
+
+        // Alignment of the first cell of a Buffer, in bytes (one cache line).
+        const std::size_t buffer_alignment = 64;
+
+        /** Minimal allocator returning memory aligned on ALIGN bytes.
+         *
+         * Used by Buffer so that the base pointer starts on a cache line.
+         */
+        template<typename T, std::size_t ALIGN = buffer_alignment>
+        class Aligned
+        {
+            public:
+                using value_type = T;
+
+                template<typename U>
+                struct rebind { using other = Aligned<U,ALIGN>; };
+
+                Aligned() = default;
+
+                template<typename U>
+                Aligned(const Aligned<U,ALIGN>&) {}
+
+                T* allocate(std::size_t n);
+
+                void deallocate(T* p, std::size_t n);
+        };
+
+        template<typename T, typename U, std::size_t ALIGN>
+        bool operator==(const Aligned<T,ALIGN>&, const Aligned<U,ALIGN>&) {return true;}
+
+        template<typename T, typename U, std::size_t ALIGN>
+        bool operator!=(const Aligned<T,ALIGN>&, const Aligned<U,ALIGN>&) {return false;}
+
+
+        /** Non-owning view over a row-major block of cells.
+         *
+         * Mimics the read/write interface of nested std::vector (size, empty, operator[], at, iteration),
+         * so that code written against the former nested storage keeps working.
+         * Indexing the first axis returns a view of dimension DIM-1, down to a single cell.
+         *
+         * Views are cheap to copy and are invalidated by any reallocation of the underlying Buffer.
+         */
+        template<std::size_t DIM, typename T>
+        class View
+        {
+            protected:
+                T* _first;
+                std::array<std::size_t,DIM> _sizes;
+
+            public:
+                using value_type = View<DIM-1,T>;
+
+                // Iterator over the items of the first axis, yielding sub-views.
+                class iterator
+                {
+                    public:
+                        using iterator_category = std::forward_iterator_tag;
+                        using value_type = View<DIM-1,T>;
+                        using difference_type = std::ptrdiff_t;
+                        using pointer = View<DIM-1,T>*;
+                        using reference = View<DIM-1,T>;
+                    protected:
+                        const View<DIM,T>* _view;
+                        std::size_t _i;
+                    public:
+                        iterator(const View<DIM,T>* view, std::size_t i) : _view(view), _i(i) {}
+                        View<DIM-1,T> operator*() const {return (*_view)[_i];}
+                        iterator& operator++() {_i++; return *this;}
+                        bool operator==(const iterator& other) const {return _i == other._i and _view == other._view;}
+                        bool operator!=(const iterator& other) const {return not (*this == other);}
+                };
+
+                View(T* first, std::array<std::size_t,DIM> sizes) : _first(first), _sizes(sizes) {}
+
+                // Number of items along the first axis.
+                std::size_t size() const {return _sizes[0];}
+
+                bool empty() const {return _sizes[0] == 0;}
+
+                // Number of cells between two consecutive items of the first axis.
+                std::size_t stride() const;
+
+                // Sub-view of the i-th item along the first axis.
+                View<DIM-1,T> operator[](std::size_t i) const;
+
+                // Bounds-checked (in debug mode) alias to operator[].
+                View<DIM-1,T> at(std::size_t i) const;
+
+                iterator begin() const {return iterator(this, 0);}
+                iterator end() const {return iterator(this, _sizes[0]);}
+
+                // Pointer to the first cell of the view.
+                T* data() const {return _first;}
+        };
+
+        // Specialization of View for a single row of cells.
+        template<typename T>
+        class View<1,T>
+        {
+            protected:
+                T* _first;
+                std::size_t _size;
+
+            public:
+                using value_type = T;
+                using iterator = T*;
+
+                View(T* first, std::array<std::size_t,1> sizes) : _first(first), _size(sizes[0]) {}
+
+                std::size_t size() const {return _size;}
+
+                bool empty() const {return _size == 0;}
+
+                T& operator[](std::size_t i) const {return _first[i];}
+
+                T& at(std::size_t i) const {assert(i < _size); return _first[i];}
+
+                iterator begin() const {return _first;}
+                iterator end() const {return _first + _size;}
+
+                T* data() const {return _first;}
+        };
+
+
+        /** Row-major contiguous storage for DIM-dimensional grids of cells.
+         *
+         * All the cells are held in a single allocation, aligned on buffer_alignment bytes.
+         * Cell (i_0,…,i_{DIM-1}) is stored at offset Σ i_d × stride_d,
+         * the last axis being the contiguous one.
+         */
+        template<std::size_t DIM, typename T>
+        class Buffer
+        {
+            public:
+                using value_type = T;
+                using iterator = T*;
+                using const_iterator = const T*;
+
+            protected:
+                std::array<std::size_t,DIM> _sizes;
+                std::array<std::size_t,DIM> _strides;
+                std::vector<T,Aligned<T>> _cells;
+
+            public:
+                // Empty buffer.
+                Buffer();
+
+                // Buffer of the given sizes, all the cells set to fill.
+                Buffer(std::array<std::size_t,DIM> sizes, T fill = T());
+
+                // Number of cells along each axis.
+                const std::array<std::size_t,DIM>& sizes() const {return _sizes;}
+
+                // Number of cells between two consecutive items of each axis.
+                const std::array<std::size_t,DIM>& strides() const {return _strides;}
+
+                // Total number of cells.
+                std::size_t size() const {return _cells.size();}
+
+                // Offset of the given cell from the base pointer.
+                std::size_t offset(const std::array<std::size_t,DIM>& coords) const;
+
+                /** Accessor to a cell.
+                 *
+                 * params DIM indices.
+                 */
+                template<class... Ts>
+                T& operator()(Ts... coords);
+
+                template<class... Ts>
+                const T& operator()(Ts... coords) const;
+
+                // Set all the cells to the given value.
+                void fill(T value);
+
+                // Base pointer.
+                T* data() {return _cells.data();}
+                const T* data() const {return _cells.data();}
+
+                iterator begin() {return _cells.data();}
+                iterator end() {return _cells.data() + _cells.size();}
+                const_iterator begin() const {return _cells.data();}
+                const_iterator end() const {return _cells.data() + _cells.size();}
+
+                // Nested-containers-like view over the cells.
+                View<DIM,T> view();
+                View<DIM,const T> view() const;
+        };
+
+    } // domain
+
+} // ealain
+
+#include "buffer.hpp"
+
+#endif // __EALAIN_BUFFER_H__
@@ -0,0 +1,112 @@
+#include <new>
+#include <algorithm>
+
+namespace ealain {
+namespace domain {
+
+// Aligned
+
+template<typename T, std::size_t ALIGN>
+T* Aligned<T,ALIGN>::allocate(std::size_t n)
+{
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(ALIGN)));
+}
+
+template<typename T, std::size_t ALIGN>
+void Aligned<T,ALIGN>::deallocate(T* p, std::size_t)
+{
+    ::operator delete(p, std::align_val_t(ALIGN));
+}
+
+// View
+
+template<std::size_t DIM, typename T>
+std::size_t View<DIM,T>::stride() const
+{
+    std::size_t s = 1;
+    for(std::size_t d = 1; d < DIM; ++d) {
+        s *= _sizes[d];
+    }
+    return s;
+}
+
+template<std::size_t DIM, typename T>
+View<DIM-1,T> View<DIM,T>::operator[](std::size_t i) const
+{
+    std::array<std::size_t,DIM-1> sub;
+    std::copy(std::begin(_sizes)+1, std::end(_sizes), std::begin(sub));
+    return View<DIM-1,T>(_first + i * stride(), sub);
+}
+
+template<std::size_t DIM, typename T>
+View<DIM-1,T> View<DIM,T>::at(std::size_t i) const
+{
+    assert(i < _sizes[0]);
+    return (*this)[i];
+}
+
+// Buffer
+
+template<std::size_t DIM, typename T>
+Buffer<DIM,T>::Buffer() : Buffer(std::array<std::size_t,DIM>{})
+{}
+
+template<std::size_t DIM, typename T>
+Buffer<DIM,T>::Buffer(std::array<std::size_t,DIM> sizes, T fill) :
+    _sizes(sizes)
+{
+    std::size_t n = 1;
+    for(std::size_t d = DIM; d > 0; --d) {
+        _strides[d-1] = n;
+        n *= _sizes[d-1];
+    }
+    _cells.assign(n, fill);
+}
+
+template<std::size_t DIM, typename T>
+std::size_t Buffer<DIM,T>::offset(const std::array<std::size_t,DIM>& coords) const
+{
+    std::size_t o = 0;
+    for(std::size_t d = 0; d < DIM; ++d) {
+        assert(coords[d] < _sizes[d]);
+        o += coords[d] * _strides[d];
+    }
+    return o;
+}
+
+template<std::size_t DIM, typename T>
+template<class... Ts>
+T& Buffer<DIM,T>::operator()(Ts... coords)
+{
+    static_assert(sizeof...(coords) == DIM, "Wrong number of dimensions");
+    return _cells[ offset({static_cast<std::size_t>(coords)...}) ];
+}
+
+template<std::size_t DIM, typename T>
+template<class... Ts>
+const T& Buffer<DIM,T>::operator()(Ts... coords) const
+{
+    static_assert(sizeof...(coords) == DIM, "Wrong number of dimensions");
+    return _cells[ offset({static_cast<std::size_t>(coords)...}) ];
+}
+
+template<std::size_t DIM, typename T>
+void Buffer<DIM,T>::fill(T value)
+{
+    std::fill(std::begin(_cells), std::end(_cells), value);
+}
+
+template<std::size_t DIM, typename T>
+View<DIM,T> Buffer<DIM,T>::view()
+{
+    return View<DIM,T>(_cells.data(), _sizes);
+}
+
+template<std::size_t DIM, typename T>
+View<DIM,const T> Buffer<DIM,T>::view() const
+{
+    return View<DIM,const T>(_cells.data(), _sizes);
+}
+
+} // domain
+} // ealain
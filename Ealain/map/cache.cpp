@@ -0,0 +1,211 @@
+#include <functional>
+
+#include "../trace.h"
+#include "geometry.h"
+#include "cache.h"
+
+namespace ealain {
+namespace geom {
+
+bool VisibilityCache::Key::operator==(const Key& other) const
+{
+    return row == other.row and col == other.col
+       and window.row_min == other.window.row_min and window.col_min == other.window.col_min
+       and window.row_max == other.window.row_max and window.col_max == other.window.col_max;
+}
+
+size_t VisibilityCache::Hash::operator()(const Key& key) const
+{
+    size_t h = 0;
+    for(size_t v : {key.row, key.col,
+                    key.window.row_min, key.window.col_min, key.window.row_max, key.window.col_max}) {
+        h ^= std::hash<size_t>()(v) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+VisibilityCache::VisibilityCache(const inst::Map& map, size_t budget, Visibility engine) :
+    _map(&map),
+    _walls(geom::walls(map)),
+    _budget(budget),
+    _engine(engine),
+    _geometry(nullptr),
+    _proj(nullptr),
+    _pyramid(nullptr),
+    _level(0),
+    _memory(0),
+    _hits(0),
+    _misses(0),
+    _evictions(0)
+{}
+
+VisibilityCache::VisibilityCache(const domain::Bits& walls, size_t budget, Visibility engine) :
+    _map(nullptr),
+    _walls(walls),
+    _budget(budget),
+    _engine(engine),
+    _geometry(nullptr),
+    _proj(nullptr),
+    _pyramid(nullptr),
+    _level(0),
+    _memory(0),
+    _hits(0),
+    _misses(0),
+    _evictions(0)
+{}
+
+VisibilityCache::VisibilityCache(const inst::Geometry& geometry, const proj::Projection<double,size_t>& p,
+        const domain::Bits& walls, size_t budget) :
+    _map(nullptr),
+    _walls(walls),
+    _budget(budget),
+    _engine(Visibility::analytic),
+    _geometry(&geometry),
+    _proj(&p),
+    _pyramid(nullptr),
+    _level(0),
+    _memory(0),
+    _hits(0),
+    _misses(0),
+    _evictions(0)
+{}
+
+VisibilityCache::VisibilityCache(const inst::Pyramid& pyramid, size_t level, size_t budget, Visibility engine) :
+    _map(&pyramid.map(level)),
+    _walls(pyramid.walls(level)),
+    _budget(budget),
+    _engine(engine),
+    _geometry(nullptr),
+    _proj(nullptr),
+    _pyramid(&pyramid),
+    _level(level),
+    _memory(0),
+    _hits(0),
+    _misses(0),
+    _evictions(0)
+{}
+
+VisibilityCache::Map VisibilityCache::operator()(size_t row, size_t col, const Box& window)
+{
+    const Key key{row, col, window};
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto found = _entries.find(key);
+        if(found != std::end(_entries)) {
+            _hits++;
+            EALAIN_COUNT(cache_hit, window.rows() * window.cols());
+            _recent.splice(std::begin(_recent), _recent, found->second.recent);
+            return found->second.map;
+        }
+        _misses++;
+        EALAIN_COUNT(cache_miss, window.rows() * window.cols());
+    }
+
+    // Compute without holding the lock, so that other threads are not blocked.
+    Map computed;
+    {
+        EALAIN_TRACE(visibility, window.rows() * window.cols());
+        auto visibles = std::make_shared<domain::Bits>(window.rows(), window.cols());
+        if(_geometry) {
+            visibility_map_2D(*visibles, *_geometry, *_proj, row, col, window);
+        } else if(_pyramid) {
+            _pyramid->visibility(*visibles, _level, row, col, window, _engine);
+        } else {
+            visibility_map_2D(*visibles, _walls, row, col, window, _engine);
+        }
+        computed = visibles;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto found = _entries.find(key);
+    if(found != std::end(_entries)) {
+        // Another thread computed the same map meanwhile.
+        return found->second.map;
+    }
+    const size_t bytes = computed->memory();
+    if(bytes <= _budget) {
+        _recent.push_front(key);
+        _entries.emplace(key, Entry{computed, std::begin(_recent)});
+        _memory += bytes;
+        evict();
+    }
+    return computed;
+}
+
+void VisibilityCache::evict()
+{
+    while(_memory > _budget) {
+        assert(not _recent.empty());
+        auto oldest = _entries.find(_recent.back());
+        assert(oldest != std::end(_entries));
+        _memory -= oldest->second.map->memory();
+        _entries.erase(oldest);
+        _recent.pop_back();
+        _evictions++;
+    }
+}
+
+const inst::Map& VisibilityCache::map() const
+{
+    assert(_map);
+    return *_map;
+}
+
+const domain::Bits& VisibilityCache::walls() const
+{
+    return _walls;
+}
+
+void VisibilityCache::budget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _budget = bytes;
+    evict();
+}
+
+size_t VisibilityCache::budget() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _budget;
+}
+
+size_t VisibilityCache::memory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _memory;
+}
+
+size_t VisibilityCache::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+size_t VisibilityCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+}
+
+size_t VisibilityCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+}
+
+size_t VisibilityCache::evictions() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _evictions;
+}
+
+void VisibilityCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _recent.clear();
+    _memory = 0;
+}
+
+} // geom
+} // ealain
@@ -0,0 +1,155 @@
+#ifndef __EALAIN_CACHE_H__
+#define __EALAIN_CACHE_H__
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "bits.h"
+#include "geom.h"
+#include "instance.h"
+#include "pyramid.h"
+
+namespace ealain {
+
+    namespace inst {
+        class Geometry;
+    } // inst
+
+    namespace geom {
+
+        /** Visibility maps of a given map, shared across sensors.
+         *
+         * Maps are keyed by the sensor cell and the window they cover,
+         * and handed out as immutable shared bit-packed maps,
+         * so that all the sensors located on the same cell share the same copy.
+         *
+         * The cache keeps at most `budget` bytes of maps,
+         * evicting the least recently used ones first.
+         * Evicted maps remain valid for as long as a sensor holds them.
+         *
+         * All the methods are thread-safe.
+         */
+        class VisibilityCache
+        {
+            public:
+                using Map = std::shared_ptr<const domain::Bits>;
+
+            protected:
+                struct Key
+                {
+                    size_t row;
+                    size_t col;
+                    Box window;
+
+                    bool operator==(const Key& other) const;
+                };
+
+                struct Hash
+                {
+                    size_t operator()(const Key& key) const;
+                };
+
+                using Recent = std::list<Key>;
+
+                struct Entry
+                {
+                    Map map;
+                    // Position in the recently used list.
+                    Recent::iterator recent;
+                };
+
+                // Map of the cache, nullptr if built from walls only.
+                const inst::Map* _map;
+                // Bit-packed occupancy of the map, read by the visibility algorithms.
+                const domain::Bits _walls;
+                size_t _budget;
+                Visibility _engine;
+
+                // Wall geometry which maps are computed analytically, with its projection, if any.
+                const inst::Geometry* _geometry;
+                const proj::Projection<double,size_t>* _proj;
+
+                // Level of a pyramid which maps are computed, if any.
+                const inst::Pyramid* _pyramid;
+                size_t _level;
+
+                mutable std::mutex _mutex;
+
+                std::unordered_map<Key,Entry,Hash> _entries;
+
+                // Most recently used first.
+                Recent _recent;
+
+                // Bytes used by the stored maps.
+                size_t _memory;
+
+                size_t _hits;
+                size_t _misses;
+                size_t _evictions;
+
+                // Remove least recently used entries until the memory fits in the budget.
+                // Expects the mutex to be held.
+                void evict();
+
+            public:
+                /** Constructor
+                 *
+                 * budget maximum number of bytes of visibility maps kept in the cache.
+                 * engine algorithm used to compute missing maps.
+                 */
+                VisibilityCache(const inst::Map& map, size_t budget, Visibility engine = Visibility::sweep);
+
+                // Cache of the maps of the given bit-packed walls, without any dense map.
+                VisibilityCache(const domain::Bits& walls, size_t budget, Visibility engine = Visibility::sweep);
+
+                /** Cache of maps computed analytically from the given wall geometry, rasterized into walls.
+                 *
+                 * The geometry and projection should outlive the cache.
+                 */
+                VisibilityCache(const inst::Geometry& geometry, const proj::Projection<double,size_t>& p,
+                        const domain::Bits& walls, size_t budget);
+
+                /** Cache of the maps of a level of a pyramid, computed with Pyramid::visibility.
+                 *
+                 * The pyramid should outlive the cache.
+                 */
+                VisibilityCache(const inst::Pyramid& pyramid, size_t level, size_t budget, Visibility engine = Visibility::sweep);
+
+                /** Visibility map from the given cell, only covering the given window.
+                 *
+                 * Computed on a miss, pixel (i,j) being at (i-window.row_min, j-window.col_min).
+                 */
+                Map operator()(size_t row, size_t col, const Box& window);
+
+                // Map of the cache, which should have been built from one.
+                const inst::Map& map() const;
+
+                // Walls the maps are computed on.
+                const domain::Bits& walls() const;
+
+                // Change the memory budget, evicting entries if necessary.
+                void budget(size_t bytes);
+                size_t budget() const;
+
+                // Bytes currently used by the stored maps.
+                size_t memory() const;
+
+                // Number of stored maps.
+                size_t size() const;
+
+                // Counters of requests served from the cache, computed, and of evicted maps.
+                size_t hits() const;
+                size_t misses() const;
+                size_t evictions() const;
+
+                // Drop all the stored maps, counters are kept.
+                void clear();
+        };
+
+    } // geom
+
+} // ealain
+
+#endif // __EALAIN_CACHE_H__
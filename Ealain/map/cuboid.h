@@ -18,8 +18,9 @@ namespace ealain {
             public:
                 using iterator = Cuboid_iterator<T>;
                 using data_type = typename Domain<3,T>::data_type;
+                using nested_type = typename Domain<3,T>::nested_type;
 
-                CuboidT( data_type data );
+                CuboidT( const nested_type& data );
 
                 CuboidT(std::size_t lines, std::size_t columns, std::size_t frames, T fill = 0);
 
@@ -46,19 +47,24 @@ namespace ealain {
         template<typename T=double>
         std::vector<std::vector<double>> slice_at_angle(const CuboidT<T>& domain, unsigned int angle_idx);
 
-        // An iterator over a whole Cuboid.
+        /** An iterator over a whole Cuboid.
+         *
+         * Walks the contiguous storage with a raw pointer,
+         * while keeping track of the current coordinates.
+         */
         template<typename T/*=double*/>
-        class Cuboid_iterator : public std::iterator<std::bidirectional_iterator_tag, double>
+        class Cuboid_iterator : public std::iterator<std::bidirectional_iterator_tag, T>
         {
         protected:
-            CuboidT<T>* _domain;
+            T* _cell;
+            std::array<std::size_t,3> _sizes;
             std::size_t _i_cut;
             std::size_t _j_row;
             std::size_t _k_col;
 
             Cuboid_iterator(
-                    CuboidT<T>* cuboid = nullptr,
-                    std::vector<std::size_t> coords = {0,0,0}
+                    CuboidT<T>* cuboid,
+                    std::array<std::size_t,3> coords = {0,0,0}
                 );
 
         public:
@@ -77,9 +83,9 @@ namespace ealain {
 
             static Cuboid_iterator<T> end(CuboidT<T>& plan);
 
-            double& operator*();
+            T& operator*();
 
-            const double& operator*() const;
+            const T& operator*() const;
 
             Cuboid_iterator<T>& operator++();
 
@@ -5,7 +5,7 @@ namespace domain {
 // Cuboid
 
 template<typename T>
-CuboidT<T>::CuboidT( data_type data ) : Domain<3,T>(data) {}
+CuboidT<T>::CuboidT( const nested_type& data ) : Domain<3,T>(data) {}
 
 template<typename T>
 CuboidT<T>::CuboidT(std::size_t lines, std::size_t columns, std::size_t frames, T fill) :
@@ -25,29 +25,25 @@ CuboidT<T>::CuboidT(proj::Projection<T,size_t> p, T fill) :
 template<typename T>
 const T& CuboidT<T>::at(std::vector<std::size_t> coords) const
 {
-    return this->_data[coords[0]][coords[1]][coords[2]];
+    return this->_data(coords[0], coords[1], coords[2]);
 }
 
 template<typename T>
 T& CuboidT<T>::at(std::vector<std::size_t> coords)
 {
-    return this->_data[coords[0]][coords[1]][coords[2]];
+    return this->_data(coords[0], coords[1], coords[2]);
 }
 
 template<typename T>
 std::size_t CuboidT<T>::size() const
 {
-    assert(this->_data.size() > 0);
-    assert(this->_data.at(0).size() > 0);
-    return this->_data.size() * this->_data.at(0).size() * this->_data.at(0).at(0).size();
+    return this->_data.size();
 }
 
 template<typename T>
 std::array<std::size_t,3> CuboidT<T>::sizes() const
 {
-    assert(this->_data.size() > 0);
-    assert(this->_data.at(0).size() > 0);
-    return { this->_data.size(), this->_data.at(0).size(), this->_data.at(0).at(0).size() };
+    return this->_data.sizes();
 }
 
 
@@ -69,13 +65,12 @@ typename CuboidT<T>::iterator CuboidT<T>::end()
 template<typename T>
 std::vector<std::vector<double>> slice_at_angle(const CuboidT<T>& domain, unsigned int angle_idx)
 {
-    std::vector<std::vector<double>> slice;
-    for(auto&& mat_x : domain.data()) {
-        std::vector<double> line;
-        for(auto&& line_y : mat_x ) {
-            line.push_back(line_y[angle_idx]);
+    const auto& cells = domain.buffer();
+    std::vector<std::vector<double>> slice(cells.sizes()[0], std::vector<double>(cells.sizes()[1]));
+    for(std::size_t i=0; i < cells.sizes()[0]; ++i) {
+        for(std::size_t j=0; j < cells.sizes()[1]; ++j) {
+            slice[i][j] = cells(i, j, angle_idx);
         }
-        slice.push_back(line);
     }
     return slice;
 }
@@ -86,15 +81,17 @@ std::vector<std::vector<double>> slice_at_angle(const CuboidT<T>& domain, unsign
 template<typename T>
 Cuboid_iterator<T>::Cuboid_iterator(
         CuboidT<T>* cuboid,
-        std::vector<std::size_t> coords
+        std::array<std::size_t,3> coords
     ) :
-    _domain(cuboid),
-    _i_cut(coords.at(0)),
-    _j_row(coords.at(1)),
-    _k_col(coords.at(2))
-{
-    assert(coords.size() == 3);
-}
+    _cell(cuboid->buffer().data()
+          + coords[0] * cuboid->buffer().strides()[0]
+          + coords[1] * cuboid->buffer().strides()[1]
+          + coords[2]),
+    _sizes(cuboid->buffer().sizes()),
+    _i_cut(coords[0]),
+    _j_row(coords[1]),
+    _k_col(coords[2])
+{ }
 
 template<typename T>
 Cuboid_iterator<T> Cuboid_iterator<T>::begin(CuboidT<T>& cube) {
@@ -103,36 +100,32 @@ Cuboid_iterator<T> Cuboid_iterator<T>::begin(CuboidT<T>& cube) {
 
 template<typename T>
 Cuboid_iterator<T> Cuboid_iterator<T>::end(CuboidT<T>& cube) {
-    return Cuboid_iterator<T>(&cube, {cube.data().size(), 0, 0});
+    return Cuboid_iterator<T>(&cube, {cube.buffer().sizes()[0], 0, 0});
 }
 
 template<typename T>
-double& Cuboid_iterator<T>::operator*()
+T& Cuboid_iterator<T>::operator*()
 {
-    return const_cast<double&>(static_cast<const CuboidT<T>&>(*_domain).at({_i_cut,_j_row,_k_col}));
+    return *_cell;
 }
 
 template<typename T>
-const double& Cuboid_iterator<T>::operator*() const
+const T& Cuboid_iterator<T>::operator*() const
 {
-    return _domain->at({_i_cut,_j_row,_k_col});
+    return *_cell;
 }
 
 template<typename T>
 Cuboid_iterator<T>& Cuboid_iterator<T>::operator++()
 {
-    if(_k_col + 1 < _domain->data()[_i_cut][_j_row].size()) {
-        _k_col++;
-    } else {
-        if(_j_row + 1 < _domain->data()[_i_cut].size()) {
-            _j_row++;
-        } else {
-            do {
-                _i_cut++;
-            } while(_i_cut < _domain->data().size() and _domain->data()[_i_cut].empty());
+    // Storage is contiguous, the pointer only has to move forward.
+    ++_cell;
+    if(++_k_col == _sizes[2]) {
+        _k_col = 0;
+        if(++_j_row == _sizes[1]) {
             _j_row = 0;
+            _i_cut++;
         }
-        _k_col = 0;
     }
     return *this;
 }
@@ -140,19 +133,17 @@ Cuboid_iterator<T>& Cuboid_iterator<T>::operator++()
 template<typename T>
 Cuboid_iterator<T>& Cuboid_iterator<T>::operator--()
 {
+    --_cell;
     if(_k_col > 0) {
         _k_col--;
     } else {
+        _k_col = _sizes[2] - 1;
         if(_j_row > 0) {
             _j_row--;
         } else {
-            do {
-                _i_cut--;
-            } while(_domain->data()[_i_cut].empty());
-
-            _j_row = _domain->data()[_i_cut].size() - 1;
+            _j_row = _sizes[1] - 1;
+            _i_cut--;
         }
-        _k_col = _domain->data()[_i_cut][_j_row].size() - 1;
     }
     return *this;
 }
@@ -176,10 +167,7 @@ Cuboid_iterator<T> Cuboid_iterator<T>::operator--(int)
 template<typename T>
 bool Cuboid_iterator<T>::operator==(const Cuboid_iterator<T>& other) const
 {
-    return other._domain  == _domain
-       and other._i_cut   == _i_cut
-       and other._j_row   == _j_row
-       and other._k_col   == _k_col;
+    return other._cell == _cell;
 }
 
 template<typename T>
@@ -191,8 +179,8 @@ bool Cuboid_iterator<T>::operator!=(const Cuboid_iterator<T> &other) const
 template<typename T>
 std::size_t Cuboid_iterator<T>::operator()(std::size_t dimension) const
 {
-    std::array<std::size_t,3> coords = {_i_cut,_j_row,_k_col};
-    return coords[dimension];
+    assert(dimension < 3);
+    return dimension == 0 ? _i_cut : (dimension == 1 ? _j_row : _k_col);
 }
 
 } // domain
@@ -3,9 +3,11 @@
 
 #include <vector>
 #include <array>
+#include <algorithm>
 
 #include <cassert>
 #include "projection.h"
+#include "buffer.h"
 
 namespace ealain {
 
@@ -53,6 +55,17 @@ namespace ealain {
                 T& operator[](std::vector<std::size_t> coords) const
                 {return this->at(coords);}
 
+                /** Allocation-free accessor to an item.
+                 *
+                 * coords array of DIM indices.
+                 * returns a reference to the item.
+                 */
+                virtual
+                T& operator()(const std::array<std::size_t,DIM>& coords) = 0;
+
+                virtual const
+                T& operator()(const std::array<std::size_t,DIM>& coords) const = 0;
+
                 /** Accessor to an item
                  *
                  * params DIM number of indices arguments.
@@ -62,8 +75,7 @@ namespace ealain {
                 T& operator()(Ts... params)
                 {
                     static_assert(sizeof...(params) == DIM, "Wrong number of dimensions");
-                    const std::vector<std::size_t> coords = {params...};
-                    return this->at(coords);
+                    return (*this)(std::array<std::size_t,DIM>{static_cast<std::size_t>(params)...});
                 }
 
                 //Number of items in the whole domain.
@@ -115,32 +127,68 @@ namespace ealain {
         class Domain<2,T> : public DomainBase<2,T>
         {
             public:
-                using data_type = std::vector<std::vector<T>>;
+                //Contiguous, row-major, storage of the cells.
+                using storage_type = Buffer<2,T>;
+                //Nested containers, accepted by the compatibility constructor.
+                using nested_type = std::vector<std::vector<T>>;
+                //View mimicking nested containers, returned by data().
+                using data_type = View<2,T>;
+                using const_data_type = View<2,const T>;
 
             protected:
-                data_type _data;
+                storage_type _data;
 
             public:
-                Domain<2,T>(data_type data) : _data(data) {}
+                //Copy nested containers, all the rows should have the same size.
+                Domain<2,T>(const nested_type& data) :
+                    _data({data.size(), data.size() > 0 ? data[0].size() : 0})
+                {
+                    for(std::size_t i=0; i < data.size(); ++i) {
+                        assert(data[i].size() == _data.sizes()[1]);
+                        std::copy(std::begin(data[i]), std::end(data[i]),
+                                _data.begin() + i * _data.strides()[0]);
+                    }
+                }
 
                 Domain<2,T>(std::size_t lines, std::size_t columns, T fill = 0) :
-                    _data(lines, std::vector<T>(columns, fill))
+                    _data({lines, columns}, fill)
                 {}
 
                 Domain<2,T>(proj::Projection<T,size_t> m, T fill = 0) :
                     //Plus one, because the semantic of underlying ranges
                     //is to be closed intervals.
-                    _data(m[0].range_idx().max()+1,
-                            std::vector<T>(m[1].range_idx().max()+1,
-                                fill))
+                    _data({m[0].range_idx().max()+1, m[1].range_idx().max()+1}, fill)
                 {
-                    assert(_data.size() == m[0].range_idx().max()+1);
-                    assert(_data.size() > 0);
-                    assert(_data[0].size() == m[1].range_idx().max()+1);
+                    assert(_data.sizes()[0] > 0);
                 }
 
-                data_type& data() {return _data;}
-                const data_type& data() const {return _data;}
+                //Compatibility view over the cells, indexable as data()[i][j].
+                data_type data() {return _data.view();}
+                const_data_type data() const {return _data.view();}
+
+                //Accessor to the contiguous storage.
+                storage_type& buffer() {return _data;}
+                const storage_type& buffer() const {return _data;}
+
+                /** Accessors to an item, resolved at compile time on the storage.
+                 *
+                 * Those hide the ones of DomainBase, so that calls on a known
+                 * domain type do not go through virtual dispatch.
+                 */
+                T& operator()(const std::array<std::size_t,2>& coords) final
+                {return _data.data()[_data.offset(coords)];}
+
+                const
+                T& operator()(const std::array<std::size_t,2>& coords) const final
+                {return _data.data()[_data.offset(coords)];}
+
+                template<class... Ts>
+                T& operator()(Ts... params)
+                {return _data(params...);}
+
+                template<class... Ts>
+                const T& operator()(Ts... params) const
+                {return _data(params...);}
         };
 
         //Specialization of Domain for 3D.
@@ -148,26 +196,71 @@ namespace ealain {
         class Domain<3,T> : public DomainBase<3,T>
         {
             public:
-                using data_type = std::vector<std::vector<std::vector<T>>>;
+                //Contiguous, row-major, storage of the cells.
+                using storage_type = Buffer<3,T>;
+                //Nested containers, accepted by the compatibility constructor.
+                using nested_type = std::vector<std::vector<std::vector<T>>>;
+                //View mimicking nested containers, returned by data().
+                using data_type = View<3,T>;
+                using const_data_type = View<3,const T>;
             protected:
-                data_type _data;
+                storage_type _data;
             public:
-                Domain<3,T>(data_type data) : _data(data) {}
+                //Copy nested containers, all the sub-containers should have the same size.
+                Domain<3,T>(const nested_type& data) :
+                    _data({data.size(),
+                           data.size() > 0 ? data[0].size() : 0,
+                           data.size() > 0 and data[0].size() > 0 ? data[0][0].size() : 0})
+                {
+                    for(std::size_t i=0; i < data.size(); ++i) {
+                        assert(data[i].size() == _data.sizes()[1]);
+                        for(std::size_t j=0; j < data[i].size(); ++j) {
+                            assert(data[i][j].size() == _data.sizes()[2]);
+                            std::copy(std::begin(data[i][j]), std::end(data[i][j]),
+                                    _data.begin() + i * _data.strides()[0] + j * _data.strides()[1]);
+                        }
+                    }
+                }
 
                 Domain<3,T>(std::size_t lines, std::size_t columns, std::size_t frames, T fill = 0) :
-                    _data(lines, std::vector<std::vector<T>>(columns, std::vector<T>(frames, fill)))
+                    _data({lines, columns, frames}, fill)
                 {}
 
                 Domain<3,T>(proj::Projection<T,size_t> m, T fill = 0) :
                     //Plus one, because the semantic of underlying ranges
                     //is to be closed intervals.
-                    _data(m[0].range_idx().max()+1,
-                            std::vector<std::vector<T>>(m[1].range_idx().max()+1,
-                                std::vector<T>(m[2].range_idx().max()+1,
-                                    fill)))
+                    _data({m[0].range_idx().max()+1,
+                           m[1].range_idx().max()+1,
+                           m[2].range_idx().max()+1}, fill)
                 {}
-                data_type& data() {return _data;}
-                const data_type& data() const {return _data;}
+
+                //Compatibility view over the cells, indexable as data()[i][j][k].
+                data_type data() {return _data.view();}
+                const_data_type data() const {return _data.view();}
+
+                //Accessor to the contiguous storage.
+                storage_type& buffer() {return _data;}
+                const storage_type& buffer() const {return _data;}
+
+                /** Accessors to an item, resolved at compile time on the storage.
+                 *
+                 * Those hide the ones of DomainBase, so that calls on a known
+                 * domain type do not go through virtual dispatch.
+                 */
+                T& operator()(const std::array<std::size_t,3>& coords) final
+                {return _data.data()[_data.offset(coords)];}
+
+                const
+                T& operator()(const std::array<std::size_t,3>& coords) const final
+                {return _data.data()[_data.offset(coords)];}
+
+                template<class... Ts>
+                T& operator()(Ts... params)
+                {return _data(params...);}
+
+                template<class... Ts>
+                const T& operator()(Ts... params) const
+                {return _data(params...);}
         };
 
         //Call the atomic cost_to_proba on a whole domain.
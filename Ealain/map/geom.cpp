@@ -1,5 +1,6 @@
 #include <cmath>
 #include <limits>
+#include <array>
 #include <algorithm>
 
 #include "../utils.h"
@@ -12,7 +13,11 @@ namespace geom {
 
 double ground_distance(double target_x, double target_y, double sensor_x, double sensor_y)
 {
-    return std::sqrt( std::pow(target_x-sensor_x,2) + std::pow(target_y-sensor_y,2) );
+    // Squares as products: std::pow is not always correctly rounded,
+    // and the vectorized row kernels should compute the very same distances.
+    const double dx = target_x-sensor_x;
+    const double dy = target_y-sensor_y;
+    return std::sqrt( dx*dx + dy*dy );
 }
 
 double spatial_distance(double target_x, double target_y, double target_h, double sensor_x, double sensor_y, double sensor_h)
@@ -90,37 +95,53 @@ std::pair<bool,double> is_in_polygon(const std::vector<std::vector<double>>& pol
 }
 
 
-unsigned int full_visibility_map_2D(std::vector<std::vector<char>>& visibles, const inst::Map& map)
+size_t Box::rows() const
 {
-    // Visibles pixels assume everything is visible.
-    unsigned int i_len=map.size();
-    assert(i_len>0);
-    unsigned int j_len=map[0].size();
-    assert(j_len>0);
+    return row_max - row_min + 1;
+}
 
-    unsigned int counter = 0;
-    for (unsigned int i=0; i<i_len; i++)
-    {
-        for (unsigned int j=0; j<j_len; j++)
-        {
-            visibles[i][j] = 1;
-            counter++;
+size_t Box::cols() const
+{
+    return col_max - col_min + 1;
+}
 
-        }
-    }
+bool Box::contains(long row, long col) const
+{
+    return static_cast<long>(row_min) <= row and row <= static_cast<long>(row_max)
+       and static_cast<long>(col_min) <= col and col <= static_cast<long>(col_max);
+}
 
-    return counter;
+Box whole(const inst::Map& map)
+{
+    assert(map.size() > 0);
+    assert(map[0].size() > 0);
+    return Box{0, 0, map.size()-1, map[0].size()-1};
 }
 
-unsigned int visibility_map_2D_ray_tracing(std::vector<std::vector<char>>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, bool overwrite)
+Box whole(const domain::Bits& walls)
 {
-    // Visibles pixels.
-    unsigned int i_len=map.size();
-    assert(i_len>0);
-    unsigned int j_len=map[0].size();
-    assert(j_len>0);
+    assert(walls.rows() > 0);
+    assert(walls.cols() > 0);
+    return Box{0, 0, walls.rows()-1, walls.cols()-1};
+}
 
-    // Coordinates of pixels on the border.
+unsigned int full_visibility_map_2D(domain::PlanT<char>& visibles, [[maybe_unused]] const inst::Map& map)
+{
+    // Visibles pixels assume everything is visible.
+    assert(map.size()>0);
+    assert(map[0].size()>0);
+
+    assert(visibles.buffer().sizes()[0] == map.size());
+    assert(visibles.buffer().sizes()[1] == map[0].size());
+
+    visibles.buffer().fill(1);
+
+    return visibles.size();
+}
+
+// Targets of the rays cast by the visibility algorithms.
+static std::vector<raster::Point> border_pixels(unsigned int i_len, unsigned int j_len)
+{
     std::vector<raster::Point> border;
     for(unsigned int i=0; i < i_len; ++i) {
         border.push_back(std::make_pair(i,0));
@@ -130,53 +151,354 @@ unsigned int visibility_map_2D_ray_tracing(std::vector<std::vector<char>>& visib
         border.push_back(std::make_pair(0,j));
         border.push_back(std::make_pair(i_len-1,j));
     }
+    return border;
+}
+
+unsigned int visibility_map_2D_ray_tracing(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, bool overwrite)
+{
+    return visibility_map_2D_ray_tracing(visibles, map, sensor_i, sensor_j, whole(map), overwrite);
+}
+
+// Accessors to walls and visible pixels, so that the visibility algorithms run on plain or bit-packed grids.
+
+struct MapWalls
+{
+    const inst::Map& map;
+    bool operator()(long row, long col) const {return map[row][col] == 1;}
+};
+
+struct BitWalls
+{
+    const domain::Bits& walls;
+    bool operator()(long row, long col) const {return walls(row, col);}
+};
+
+struct CharCells
+{
+    domain::Buffer<2,char>& cells;
+    bool operator()(size_t row, size_t col) const {return cells(row, col) != 0;}
+    void set(size_t row, size_t col) {cells(row, col) = 1;}
+};
+
+/** Visit the pixels of raster::pixels_line from (i1,j1) to (i2,j2), in order, without storing them.
+ *
+ * Stops as soon as visit returns false.
+ */
+template<class Visit>
+static void walk_line(long i1, long j1, long i2, long j2, Visit visit)
+{
+    long di = i2 - i1;
+    long dj = j2 - j1;
+    const long is = di > 0 ? 1 : -1;
+    const long js = dj > 0 ? 1 : -1;
+    di = std::abs(di);
+    dj = std::abs(dj);
+    const bool row_major = di > dj;
+    if(not row_major) {
+        std::swap(di,dj);
+    }
+    long err = 2 * dj - di;
+    long j = 0;
+    for(long i = 0; i < di+1; ++i) {
+        const long row = i1 + (row_major ? i*is : j*is);
+        const long col = j1 + (row_major ? j*js : i*js);
+        if(not visit(row, col)) {
+            return;
+        }
+        if(err >= 0) {
+            j += 1;
+            err -= 2*di;
+        }
+        err += 2 * dj;
+    }
+}
+
+template<class Cells, class Walls>
+static unsigned int ray_tracing(Cells& cells, const Walls& wall, unsigned int i_len, unsigned int j_len, const int sensor_i, const int sensor_j, const Box& window, bool overwrite)
+{
+    assert(window.row_max < i_len and window.col_max < j_len);
+    assert(window.contains(sensor_i, sensor_j));
+
+    // Coordinates of pixels on the border.
+    std::vector<raster::Point> border = border_pixels(i_len, j_len);
 
     // Populate the array.
     unsigned int counter = 0;
     // If camera on a wall, visibility = 0 everywhere
-    if (map[sensor_i][sensor_j] == 1)
+    if (wall(sensor_i, sensor_j))
         return counter;
     else
     {
         for(auto&& p : border) {
+            // Rays are walked pixel by pixel, so that only their part within the window is traced.
+            walk_line(sensor_i, sensor_j, raster::row(p), raster::col(p), [&](long row, long col) {
+                // Because of rounding, the extreme points of lines may fall of out of the domain,
+                // which is covered by the window.
+                // As lines are monotonic, the remaining points are out of the window too.
+                // Neither is there anything left to see past a wall.
+                if(not window.contains(row, col) or wall(row, col)) {
+                    return false;
+                }
+                const size_t r = row - window.row_min;
+                const size_t c = col - window.col_min;
+                if(overwrite or not cells(r, c))
+                {
+                    cells.set(r, c);
+                    counter++;
+                }
+                return true;
+            });
+        } // for p in border
+    }
+    return counter;
+}
+
+unsigned int visibility_map_2D_ray_tracing(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window, bool overwrite)
+{
+    // Visibles pixels.
+    unsigned int i_len=map.size();
+    assert(i_len>0);
+    unsigned int j_len=map[0].size();
+    assert(j_len>0);
+
+    auto& buffer = visibles.buffer();
+    assert(buffer.sizes()[0] == window.rows());
+    assert(buffer.sizes()[1] == window.cols());
+    CharCells cells{buffer};
+    return ray_tracing(cells, MapWalls{map}, i_len, j_len, sensor_i, sensor_j, window, overwrite);
+}
+
+// A Bresenham ray from the sensor, in the frame of its octant:
+// it makes `major` steps along its main axis and `minor` steps along the other one.
+struct Ray
+{
+    long major;
+    long minor;
+};
+
+// Offset along the minor axis of the k-th pixel of the ray,
+// equivalent to the error accumulation of raster::line::bresenham.
+static long minor_offset(long k, const Ray& ray)
+{
+    return (2 * ray.minor * k + ray.major) / (2 * ray.major);
+}
+
+unsigned int visibility_map_2D_sweep(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j)
+{
+    return visibility_map_2D_sweep(visibles, map, sensor_i, sensor_j, whole(map));
+}
 
-            raster::Line raj = raster::pixels_line(sensor_i, sensor_j, raster::row(p), raster::col(p));
+template<class Cells, class Walls>
+static unsigned int sweep(Cells& cells, const Walls& wall, const long i_len, const long j_len, const int sensor_i, const int sensor_j, const Box& window)
+{
+    assert(window.row_max < static_cast<size_t>(i_len) and window.col_max < static_cast<size_t>(j_len));
+    assert(window.contains(sensor_i, sensor_j));
+
+    unsigned int counter = 0;
+    // If camera on a wall, visibility = 0 everywhere
+    if (wall(sensor_i, sensor_j)) {
+        return counter;
+    }
+
+    auto mark = [&cells,&counter,&window](long row, long col) {
+        const size_t r = row - window.row_min;
+        const size_t c = col - window.col_min;
+        if(not cells(r, c)) {
+            cells.set(r, c);
+            counter++;
+        }
+    };
 
-            bool visible = true;
-            for(auto&& pii : raj) {
-                raster::Point t = raster::point(pii);
+    // Every ray starts on the sensor.
+    mark(sensor_i, sensor_j);
 
-                // Because of rounding, the extreme points of lines may fall of out of the domain.
-                if( raster::row(t) < 0
-                 or raster::col(t) < 0
-                 or raster::row(t) >= map.size()
-                 or raster::col(t) >= map[raster::row(t)].size()) {
-                    // Just discard those points.
-                    continue;
+    // Group the rays by octant, indexed by: main axis (row/col), sign along it, sign along the other one.
+    // Signs follow the conventions of raster::line::bresenham, so that the pixels are the same.
+    std::array<std::vector<Ray>,8> octants;
+    for(auto&& p : border_pixels(i_len, j_len)) {
+        const long di = raster::row(p) - sensor_i;
+        const long dj = raster::col(p) - sensor_j;
+        const int is = di > 0 ? 1 : -1;
+        const int js = dj > 0 ? 1 : -1;
+        const bool row_major = std::abs(di) > std::abs(dj);
+        const int ms = row_major ? is : js;
+        const int ns = row_major ? js : is;
+        const Ray ray = row_major ? Ray{std::abs(di), std::abs(dj)} : Ray{std::abs(dj), std::abs(di)};
+        if(ray.major == 0) {
+            continue; // Ray reduced to the sensor.
+        }
+        octants[4*row_major + 2*(ms > 0) + (ns > 0)].push_back(ray);
+    }
+
+    for(size_t o=0; o < octants.size(); ++o) {
+        std::vector<Ray>& rays = octants[o];
+        if(rays.empty()) {
+            continue;
+        }
+        const bool row_major = o >= 4;
+        const int ms = (o & 2) ? 1 : -1;
+        const int ns = (o & 1) ? 1 : -1;
+
+        // Sorted by slope, the minor offsets at a given step are non-decreasing along the rays.
+        std::sort(ALL(rays), [](const Ray& a, const Ray& b) {
+            return a.minor * b.major < b.minor * a.major;
+        });
+
+        // Rays which last pixel is at the given step.
+        long max_major = 0;
+        for(const auto& ray : rays) {
+            max_major = std::max(max_major, ray.major);
+        }
+        std::vector<std::vector<size_t>> ends(max_major+1);
+        for(size_t r=0; r < rays.size(); ++r) {
+            ends[rays[r].major].push_back(r);
+        }
+
+        // Stop when the main axis leaves the window.
+        const long sensor_major = row_major ? sensor_i : sensor_j;
+        const long window_min = row_major ? window.row_min : window.col_min;
+        const long window_max = row_major ? window.row_max : window.col_max;
+        max_major = std::min(max_major, ms > 0 ? window_max - sensor_major : sensor_major - window_min);
+
+        // Bundles of consecutive rays that are neither blocked nor ended, as inclusive [first,last] indices.
+        std::vector<std::pair<size_t,size_t>> bundles = {{0, rays.size()-1}};
+        std::vector<std::pair<size_t,size_t>> next;
+        for(long k=1; k <= max_major and not bundles.empty(); ++k) {
+            next.clear();
+            for(const auto& bundle : bundles) {
+                size_t start = bundle.first;
+                size_t r = bundle.first;
+                while(r <= bundle.second) {
+                    const long v = minor_offset(k, rays[r]);
+
+                    // Last ray of the bundle crossing the same pixel,
+                    // galloping first, as far from the sensor most pixels are crossed by a single ray.
+                    size_t lo = r+1;
+                    size_t step = 1;
+                    while(lo + step - 1 <= bundle.second and minor_offset(k, rays[lo + step - 1]) <= v) {
+                        lo += step;
+                        step *= 2;
+                    }
+                    size_t hi = std::min(lo + step - 1, bundle.second+1);
+                    while(lo < hi) {
+                        const size_t mid = lo + (hi-lo)/2;
+                        if(minor_offset(k, rays[mid]) <= v) {
+                            lo = mid+1;
+                        } else {
+                            hi = mid;
+                        }
+                    }
+
+                    const long row = sensor_i + (row_major ? ms*k : ns*v);
+                    const long col = sensor_j + (row_major ? ns*v : ms*k);
+                    // Pixels falling out of the domain (or of the window) are just discarded,
+                    // as rays are monotonic, they will not come back.
+                    if(window.contains(row, col)) {
+                        if(wall(row, col)) {
+                            // Rays crossing a wall are blocked from there.
+                            if(start < r) {
+                                next.push_back(std::make_pair(start, r-1));
+                            }
+                            start = lo;
+                        } else {
+                            mark(row, col);
+                        }
+                    }
+                    r = lo;
                 }
-                if (map[raster::row(t)][raster::col(t)] == 1)
-                {
-                    visible = false;
+                if(start <= bundle.second) {
+                    next.push_back(std::make_pair(start, bundle.second));
                 }
-                if (visible)
-                {
-                    if(overwrite)
-                    {
-                        visibles[raster::row(t)][raster::col(t)] = 1;
-                        counter++;
-                    } else {
-                        if(visibles[raster::row(t)][raster::col(t)] == 0)
-                        {
-                            visibles[raster::row(t)][raster::col(t)] = 1;
-                            counter++;
+            } // for bundle
+
+            // Remove the rays that have reached their target.
+            bundles.clear();
+            auto end = std::begin(ends[k]);
+            for(const auto& bundle : next) {
+                size_t start = bundle.first;
+                while(end != std::end(ends[k]) and *end <= bundle.second) {
+                    if(*end >= start) {
+                        if(start < *end) {
+                            bundles.push_back(std::make_pair(start, *end-1));
                         }
+                        start = *end+1;
                     }
+                    ++end;
                 }
-            } // for t in raj
-        } // for p in border
-    }
+                if(start <= bundle.second) {
+                    bundles.push_back(std::make_pair(start, bundle.second));
+                }
+            }
+        } // for k
+    } // for o
+
     return counter;
 }
 
+unsigned int visibility_map_2D_sweep(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window)
+{
+    const long i_len = map.size();
+    assert(i_len>0);
+    const long j_len = map[0].size();
+    assert(j_len>0);
+
+    auto& buffer = visibles.buffer();
+    assert(buffer.sizes()[0] == window.rows());
+    assert(buffer.sizes()[1] == window.cols());
+    CharCells cells{buffer};
+    return sweep(cells, MapWalls{map}, i_len, j_len, sensor_i, sensor_j, window);
+}
+
+unsigned int visibility_map_2D(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm)
+{
+    switch(algorithm) {
+        case Visibility::sweep:
+            return visibility_map_2D_sweep(visibles, map, sensor_i, sensor_j, window);
+        case Visibility::ray_tracing:
+        default:
+            return visibility_map_2D_ray_tracing(visibles, map, sensor_i, sensor_j, window, false);
+    }
+}
+
+domain::Bits walls(const inst::Map& map)
+{
+    assert(map.size() > 0);
+    domain::Bits bits(map.size(), map[0].size());
+    for(size_t i=0; i < map.size(); ++i) {
+        for(size_t j=0; j < map[i].size(); ++j) {
+            if(map[i][j] == 1) {
+                bits.set(i, j);
+            }
+        }
+    }
+    return bits;
+}
+
+template<class Walls>
+static unsigned int visibility_bits(domain::Bits& visibles, const Walls& wall, size_t i_len, size_t j_len, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm)
+{
+    assert(visibles.rows() == window.rows());
+    assert(visibles.cols() == window.cols());
+    switch(algorithm) {
+        case Visibility::sweep:
+            return sweep(visibles, wall, i_len, j_len, sensor_i, sensor_j, window);
+        case Visibility::ray_tracing:
+        default:
+            return ray_tracing(visibles, wall, i_len, j_len, sensor_i, sensor_j, window, false);
+    }
+}
+
+unsigned int visibility_map_2D(domain::Bits& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm)
+{
+    assert(map.size() > 0 and map[0].size() > 0);
+    return visibility_bits(visibles, MapWalls{map}, map.size(), map[0].size(), sensor_i, sensor_j, window, algorithm);
+}
+
+unsigned int visibility_map_2D(domain::Bits& visibles, const domain::Bits& walls, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm)
+{
+    assert(walls.rows() > 0 and walls.cols() > 0);
+    return visibility_bits(visibles, BitWalls{walls}, walls.rows(), walls.cols(), sensor_i, sensor_j, window, algorithm);
+}
+
 } // ealain
 } // geom
@@ -4,6 +4,8 @@
 #include <cmath>
 
 #include "instance.h"
+#include "plan.h"
+#include "bits.h"
 
 namespace ealain {
 
@@ -29,8 +31,30 @@ namespace ealain {
         std::pair<bool,double> is_in_polygon(const std::vector<std::vector<double>>& poly, const std::vector<double>& point);
 
 
+        // Rectangle of pixels, all bounds are inclusive.
+        struct Box
+        {
+            size_t row_min;
+            size_t col_min;
+            size_t row_max;
+            size_t col_max;
+
+            // Number of rows covered by the box.
+            size_t rows() const;
+
+            // Number of columns covered by the box.
+            size_t cols() const;
+
+            // True if the given pixel is within the box.
+            bool contains(long row, long col) const;
+        };
+
+        // Box covering the whole map.
+        Box whole(const inst::Map& map);
+        Box whole(const domain::Bits& walls);
+
         // Compute the full visibility map as if everything was visible
-        unsigned int full_visibility_map_2D(std::vector<std::vector<char>>& visibles, const inst::Map& map);
+        unsigned int full_visibility_map_2D(domain::PlanT<char>& visibles, const inst::Map& map);
 
         /** Compute the map of pixels that are linear-sight visibles from a given camera.
          *
@@ -39,7 +63,58 @@ namespace ealain {
          * return Number of pixels that are visibles.
          */
 
-        unsigned int visibility_map_2D_ray_tracing(std::vector<std::vector<char>>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, bool overwrite = false);
+        unsigned int visibility_map_2D_ray_tracing(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, bool overwrite = false);
+
+        /** Compute the map of pixels that are linear-sight visibles from a given camera, within a window.
+         *
+         * Rays are traced toward the map's border as above, but stop as soon as they leave the window,
+         * which should contain the sensor.
+         * The visibles map only covers the window: pixel (i,j) is stored at (i-row_min, j-col_min).
+         *
+         * return Number of pixels that are visibles.
+         */
+        unsigned int visibility_map_2D_ray_tracing(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window, bool overwrite = false);
+
+        /** Compute the same visibility map as visibility_map_2D_ray_tracing, with a wavefront sweep.
+         *
+         * The Bresenham rays cast toward the border are grouped by octant and sorted by slope,
+         * so that at each step away from the sensor, consecutive rays cross consecutive pixels.
+         * Bundles of unblocked rays are then advanced all at once and split when they hit a wall.
+         * Each visible pixel is thus visited a bounded number of times (per octant),
+         * instead of once per ray crossing it.
+         *
+         * return Number of pixels that were newly marked as visibles.
+         */
+        unsigned int visibility_map_2D_sweep(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j);
+
+        /** Same as above, but only sweep and store the given window, which should contain the sensor.
+         *
+         * The visibles map only covers the window: pixel (i,j) is stored at (i-row_min, j-col_min).
+         */
+        unsigned int visibility_map_2D_sweep(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window);
+
+        // Available algorithms for computing visibility maps.
+        enum class Visibility {
+            ray_tracing, // visibility_map_2D_ray_tracing
+            sweep,       // visibility_map_2D_sweep
+            analytic     // visibility polygon against the wall geometry of an instance (see geometry.h),
+                         // ray_tracing on pixel walls
+        };
+
+        // Compute the visibility map within the given window, which should contain the sensor, with the given algorithm.
+        unsigned int visibility_map_2D(domain::PlanT<char>& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm);
+
+        /** Same as above, in a bit-packed map, eight times smaller.
+         *
+         * visibles should be cleared and cover the window.
+         */
+        unsigned int visibility_map_2D(domain::Bits& visibles, const inst::Map& map, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm);
+
+        // Bit-packed occupancy of the map: cells holding a wall (1) are set.
+        domain::Bits walls(const inst::Map& map);
+
+        // Same as above, reading walls from their bit-packed occupancy, as returned by walls().
+        unsigned int visibility_map_2D(domain::Bits& visibles, const domain::Bits& walls, const int sensor_i, const int sensor_j, const Box& window, Visibility algorithm);
 
     } // geom
 } // ealain
@@ -0,0 +1,491 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "../utils.h"
+#include "raster.h"
+#include "geometry.h"
+
+namespace ealain {
+namespace inst {
+
+// Clipping and rasterizing helpers, also used by the visibility polygon below.
+namespace {
+
+// Real-world rectangle covered by a projection.
+struct Bounds
+{
+    double min[2];
+    double max[2];
+};
+
+Bounds bounds(const proj::Projection<double,size_t>& p)
+{
+    assert(p.size() == 2);
+    return Bounds{{p[0].range_irl().min(), p[1].range_irl().min()},
+                  {p[0].range_irl().max(), p[1].range_irl().max()}};
+}
+
+// Clip the segment to the bounds (Liang-Barsky), false if it lies outside.
+bool clip(Vertex& from, Vertex& to, const Bounds& b)
+{
+    double t0 = 0, t1 = 1;
+    for(size_t d=0; d < 2; ++d) {
+        const double delta = to[d] - from[d];
+        for(const double side : {-1.0, 1.0}) {
+            // Inside when side * (from + t delta) <= side * limit.
+            const double limit = side < 0 ? b.min[d] : b.max[d];
+            const double q = side * (limit - from[d]);
+            const double r = side * delta;
+            if(r == 0) {
+                if(q < 0) {
+                    return false;
+                }
+            } else if(r > 0) {
+                t1 = std::min(t1, q / r);
+            } else {
+                t0 = std::max(t0, q / r);
+            }
+        }
+    }
+    if(t0 > t1) {
+        return false;
+    }
+    const Vertex a = from;
+    for(size_t d=0; d < 2; ++d) {
+        const double delta = to[d] - a[d];
+        from[d] = a[d] + t0 * delta;
+        to[d] = a[d] + t1 * delta;
+    }
+    return true;
+}
+
+// Clip the polygon to the bounds (Sutherland-Hodgman).
+Polygon clip(const Polygon& polygon, const Bounds& b)
+{
+    Polygon clipped = polygon;
+    for(size_t d=0; d < 2; ++d) {
+        for(const double side : {-1.0, 1.0}) {
+            const double limit = side < 0 ? b.min[d] : b.max[d];
+            auto inside = [&](const Vertex& v) {return side * (v[d] - limit) <= 0;};
+            Polygon input;
+            std::swap(input, clipped);
+            for(size_t k=0; k < input.size(); ++k) {
+                const Vertex& prev = input[(k + input.size() - 1) % input.size()];
+                const Vertex& cur = input[k];
+                if(inside(cur) != inside(prev)) {
+                    const double t = (limit - prev[d]) / (cur[d] - prev[d]);
+                    Vertex cross;
+                    for(size_t e=0; e < 2; ++e) {
+                        cross[e] = prev[e] + t * (cur[e] - prev[e]);
+                    }
+                    cross[d] = limit;
+                    clipped.push_back(cross);
+                }
+                if(inside(cur)) {
+                    clipped.push_back(cur);
+                }
+            }
+        }
+    }
+    return clipped;
+}
+
+// Call set(i,j) for each pixel of the walls of the geometry.
+template<class Set>
+void draw(const Geometry& geometry, const proj::Projection<double,size_t>& p, Set set)
+{
+    const Bounds b = bounds(p);
+    const size_t rows = p[0].range_idx().max() + 1;
+    const size_t cols = p[1].range_idx().max() + 1;
+
+    // Pixel of a vertex within the bounds.
+    auto pixel = [&](const Vertex& v) {
+        std::vector<size_t> ij(2);
+        for(size_t d=0; d < 2; ++d) {
+            ij[d] = p[d](std::min(std::max(v[d], b.min[d]), b.max[d]));
+        }
+        return ij;
+    };
+    auto line = [&](const std::vector<size_t>& a, const std::vector<size_t>& z) {
+        for(const raster::Pix& pix : raster::pixels_line(a[0], a[1], z[0], z[1])) {
+            const size_t i = raster::row(pix);
+            const size_t j = raster::col(pix);
+            if(i < rows and j < cols) {
+                set(i, j);
+            }
+        }
+    };
+
+    for(Segment segment : geometry.segments()) {
+        if(clip(segment.from, segment.to, b)) {
+            line(pixel(segment.from), pixel(segment.to));
+        }
+    }
+
+    for(const Polygon& polygon : geometry.polygons()) {
+        const Polygon clipped = clip(polygon, b);
+        if(clipped.empty()) {
+            continue;
+        }
+        std::vector<std::vector<size_t>> pixels;
+        for(const Vertex& v : clipped) {
+            pixels.push_back(pixel(v));
+        }
+        // The scan lines do not reach all the border pixels, outline them.
+        if(pixels.size() >= 3) {
+            for(const raster::Pix& pix : raster::poly::rasterize(pixels)) {
+                set(raster::row(pix), raster::col(pix));
+            }
+        }
+        for(size_t k=0; k < pixels.size(); ++k) {
+            line(pixels[k], pixels[(k+1) % pixels.size()]);
+        }
+    }
+}
+
+} // anonymous
+
+void Geometry::add(const Segment& segment)
+{
+    _segments.push_back(segment);
+}
+
+void Geometry::add(const Polygon& polygon)
+{
+    assert(polygon.size() >= 3);
+    _polygons.push_back(polygon);
+}
+
+const std::vector<Segment>& Geometry::segments() const
+{
+    return _segments;
+}
+
+const std::vector<Polygon>& Geometry::polygons() const
+{
+    return _polygons;
+}
+
+bool Geometry::empty() const
+{
+    return _segments.empty() and _polygons.empty();
+}
+
+void Geometry::rasterize(Map& map, const proj::Projection<double,size_t>& p) const
+{
+    assert(map.size() == p[0].range_idx().max() + 1);
+    assert(map.size() > 0 and map[0].size() == p[1].range_idx().max() + 1);
+    draw(*this, p, [&](size_t i, size_t j) {map[i][j] = 1;});
+}
+
+void Geometry::rasterize(domain::Bits& walls, const proj::Projection<double,size_t>& p) const
+{
+    assert(walls.rows() == p[0].range_idx().max() + 1);
+    assert(walls.cols() == p[1].range_idx().max() + 1);
+    draw(*this, p, [&](size_t i, size_t j) {walls.set(i, j);});
+}
+
+Geometry load_geometry(const std::string& filename)
+{
+    Geometry geometry;
+    std::ifstream file(filename);
+    if(not file.is_open()) {
+        throw std::runtime_error(filename + ": cannot open the walls: " + std::strerror(errno));
+    }
+    std::string line;
+    size_t number = 0;
+    while(std::getline(file, line)) {
+        number++;
+        std::istringstream fields(line);
+        std::string kind;
+        if(not (fields >> kind) or kind[0] == '#') {
+            continue;
+        }
+        Polygon vertices;
+        Vertex v;
+        while(fields >> v[0] >> v[1]) {
+            vertices.push_back(v);
+        }
+        fields.clear();
+        const bool complete = (fields >> std::ws).eof();
+        if(complete and kind == "segment" and vertices.size() == 2) {
+            geometry.add(Segment{vertices[0], vertices[1]});
+        } else if(complete and kind == "polygon" and vertices.size() >= 3) {
+            geometry.add(vertices);
+        } else {
+            std::cerr << filename << ":" << number << ": malformed wall \"" << line << "\"" << std::endl;
+        }
+    }
+    if(file.bad()) {
+        throw std::runtime_error(filename + ": cannot read the walls");
+    }
+    return geometry;
+}
+
+void save_geometry(const std::string& filename, const Geometry& geometry)
+{
+    std::ofstream file(filename);
+    if(not file.is_open()) {
+        throw std::runtime_error(filename + ": cannot write the walls: " + std::strerror(errno));
+    }
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for(const Segment& segment : geometry.segments()) {
+        file << "segment " << segment.from[0] << " " << segment.from[1]
+             << " " << segment.to[0] << " " << segment.to[1] << "\n";
+    }
+    for(const Polygon& polygon : geometry.polygons()) {
+        file << "polygon";
+        for(const Vertex& v : polygon) {
+            file << " " << v[0] << " " << v[1];
+        }
+        file << "\n";
+    }
+    file.flush();
+    if(not file.good()) {
+        throw std::runtime_error(filename + ": cannot write the walls");
+    }
+}
+
+std::pair<Map,proj::Projection<double,size_t>> rectangle_geometry(const Geometry& geometry,
+        size_t max_i, size_t max_j, double min_x, double max_x, double min_y, double max_y)
+{
+    auto instance = rectangle(max_i, max_j, min_x, max_x, min_y, max_y);
+    geometry.rasterize(instance.first, instance.second);
+    return instance;
+}
+
+std::pair<Map,proj::Projection<double,size_t>> rectangle_geometry(const Geometry& geometry,
+        size_t size_i, size_t size_j, double size_x, double size_y)
+{
+    return rectangle_geometry(geometry, size_i, size_j, 0, size_x, 0, size_y);
+}
+
+Shared share(const Geometry& geometry, const proj::Projection<double,size_t>& p, size_t cache_budget, geom::Visibility engine)
+{
+    return std::make_shared<const Instance>(geometry, p, cache_budget, engine);
+}
+
+} // inst
+
+namespace geom {
+
+namespace {
+
+double cross(const inst::Vertex& a, const inst::Vertex& b)
+{
+    return a[0] * b[1] - a[1] * b[0];
+}
+
+inst::Vertex minus(const inst::Vertex& a, const inst::Vertex& b)
+{
+    return {a[0] - b[0], a[1] - b[1]};
+}
+
+// Distance from the point to the segment.
+double distance(const inst::Vertex& v, const inst::Segment& segment)
+{
+    const inst::Vertex d = minus(segment.to, segment.from);
+    const inst::Vertex w = minus(v, segment.from);
+    const double length = d[0] * d[0] + d[1] * d[1];
+    const double t = length > 0 ? std::min(1.0, std::max(0.0, (w[0] * d[0] + w[1] * d[1]) / length)) : 0;
+    return std::hypot(w[0] - t * d[0], w[1] - t * d[1]);
+}
+
+// True if the point is inside the polygon (even-odd rule).
+bool inside(const inst::Vertex& v, const inst::Polygon& polygon)
+{
+    bool in = false;
+    for(size_t k=0, l=polygon.size()-1; k < polygon.size(); l = k++) {
+        const inst::Vertex& a = polygon[k];
+        const inst::Vertex& b = polygon[l];
+        if((a[1] > v[1]) != (b[1] > v[1])
+           and v[0] < a[0] + (v[1] - a[1]) / (b[1] - a[1]) * (b[0] - a[0])) {
+            in = not in;
+        }
+    }
+    return in;
+}
+
+// True if a wall crosses the bounds, or if they are within a polygon.
+bool walled(const inst::Geometry& geometry, const inst::Bounds& b)
+{
+    for(inst::Segment segment : geometry.segments()) {
+        if(inst::clip(segment.from, segment.to, b)) {
+            return true;
+        }
+    }
+    for(const inst::Polygon& polygon : geometry.polygons()) {
+        if(inside({b.min[0], b.min[1]}, polygon)) {
+            return true;
+        }
+        for(size_t k=0; k < polygon.size(); ++k) {
+            inst::Vertex from = polygon[k], to = polygon[(k+1) % polygon.size()];
+            if(inst::clip(from, to, b)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // anonymous
+
+inst::Polygon visibility_polygon(const inst::Geometry& geometry, const inst::Vertex& eye,
+        const inst::Vertex& min, const inst::Vertex& max)
+{
+    assert(eye[0] >= min[0] and eye[0] <= max[0] and eye[1] >= min[1] and eye[1] <= max[1]);
+    const inst::Bounds b{{min[0], min[1]}, {max[0], max[1]}};
+    const double epsilon = 1e-9 * std::max(1.0, std::hypot(max[0] - min[0], max[1] - min[1]));
+
+    // Walls within the bounds, and the bounds themselves.
+    std::vector<inst::Segment> walls = {
+        {{min[0], min[1]}, {max[0], min[1]}}, {{max[0], min[1]}, {max[0], max[1]}},
+        {{max[0], max[1]}, {min[0], max[1]}}, {{min[0], max[1]}, {min[0], min[1]}}};
+    auto add = [&](inst::Segment segment) {
+        if(inst::clip(segment.from, segment.to, b)) {
+            walls.push_back(segment);
+        }
+    };
+    for(const inst::Segment& segment : geometry.segments()) {
+        add(segment);
+    }
+    for(const inst::Polygon& polygon : geometry.polygons()) {
+        if(inside(eye, polygon)) {
+            return {};
+        }
+        for(size_t k=0; k < polygon.size(); ++k) {
+            add(inst::Segment{polygon[k], polygon[(k+1) % polygon.size()]});
+        }
+    }
+    for(size_t w=4; w < walls.size(); ++w) {
+        if(distance(eye, walls[w]) <= epsilon) {
+            return {};
+        }
+    }
+
+    // Rays toward each wall end, and on both sides of it, to go past the corners.
+    const double aside = 1e-7;
+    std::vector<double> angles;
+    angles.reserve(3 * 2 * walls.size());
+    for(const inst::Segment& wall : walls) {
+        for(const inst::Vertex& end : {wall.from, wall.to}) {
+            const double angle = std::atan2(end[1] - eye[1], end[0] - eye[0]);
+            angles.push_back(angle - aside);
+            angles.push_back(angle);
+            angles.push_back(angle + aside);
+        }
+    }
+    std::sort(ALL(angles));
+
+    inst::Polygon polygon;
+    polygon.reserve(angles.size());
+    // Each ray against every wall: quadratic in the number of walls within the bounds.
+    for(const double angle : angles) {
+        const inst::Vertex direction = {std::cos(angle), std::sin(angle)};
+        double nearest = std::numeric_limits<double>::infinity();
+        const inst::Segment* stop = nullptr;
+        for(const inst::Segment& wall : walls) {
+            const inst::Vertex along = minus(wall.to, wall.from);
+            const double denominator = cross(direction, along);
+            if(denominator == 0) {
+                continue;
+            }
+            const inst::Vertex to_wall = minus(wall.from, eye);
+            const double t = cross(to_wall, along) / denominator;
+            const double s = cross(to_wall, direction) / denominator;
+            if(t > 0 and s >= 0 and s <= 1 and t < nearest) {
+                nearest = t;
+                stop = &wall;
+            }
+        }
+        // The bounds always stop the ray, unless it runs along them.
+        if(not stop) {
+            continue;
+        }
+        inst::Vertex hit = {
+            std::min(std::max(eye[0] + nearest * direction[0], min[0]), max[0]),
+            std::min(std::max(eye[1] + nearest * direction[1], min[1]), max[1])};
+        // Rays toward (or just aside) a wall end stop on it exactly, despite rounding errors.
+        const double snap = epsilon + 10 * aside * nearest;
+        for(const inst::Vertex& end : {stop->from, stop->to}) {
+            if(std::hypot(hit[0] - end[0], hit[1] - end[1]) <= snap) {
+                hit = end;
+            }
+        }
+        if(polygon.empty() or std::hypot(hit[0] - polygon.back()[0], hit[1] - polygon.back()[1]) > epsilon) {
+            polygon.push_back(hit);
+        }
+    }
+    return polygon;
+}
+
+unsigned int visibility_map_2D(domain::Bits& visibles, const inst::Geometry& geometry,
+        const proj::Projection<double,size_t>& p, const int sensor_i, const int sensor_j, const Box& window)
+{
+    assert(visibles.rows() == window.rows());
+    assert(visibles.cols() == window.cols());
+    assert(window.contains(sensor_i, sensor_j));
+
+    const inst::Bounds b = inst::bounds(p);
+    // Pixel i covers [irl(i), irl(i+1)), as the projection truncates.
+    auto edge = [&](size_t d, size_t i) {
+        return std::min(p[d](i), b.max[d]);
+    };
+    const size_t sensor[2] = {static_cast<size_t>(sensor_i), static_cast<size_t>(sensor_j)};
+    inst::Bounds cell;
+    inst::Vertex eye;
+    for(size_t d=0; d < 2; ++d) {
+        cell.min[d] = edge(d, sensor[d]);
+        cell.max[d] = edge(d, sensor[d] + 1);
+        eye[d] = (cell.min[d] + cell.max[d]) / 2;
+    }
+    // As on pixel walls, a sensor on a wall sees nothing.
+    if(walled(geometry, cell)) {
+        return 0;
+    }
+
+    // Real-world bounds of the window, up to the next pixel which is not drawn.
+    const inst::Vertex min = {edge(0, window.row_min), edge(1, window.col_min)};
+    const inst::Vertex max = {edge(0, window.row_max + 1), edge(1, window.col_max + 1)};
+
+    const inst::Polygon polygon = visibility_polygon(geometry, eye, min, max);
+    if(polygon.empty()) {
+        return 0;
+    }
+    std::vector<std::vector<size_t>> pixels;
+    for(const inst::Vertex& v : polygon) {
+        pixels.push_back({p[0](v[0]), p[1](v[1])});
+    }
+    // Filled span by span, then outlined as the scan lines do not reach all the border pixels.
+    if(pixels.size() >= 3) {
+        raster::poly::rasterize(pixels, [&](size_t i, size_t first, size_t last) {
+            first = std::max(first, window.col_min);
+            last = std::min(last, window.col_max + 1);
+            if(window.contains(i, window.col_min) and first < last) {
+                visibles.set(i - window.row_min, first - window.col_min, last - window.col_min);
+            }
+        });
+    }
+    for(size_t k=0; k < pixels.size(); ++k) {
+        const auto& from = pixels[k];
+        const auto& to = pixels[(k+1) % pixels.size()];
+        for(const raster::Pix& pix : raster::pixels_line(from[0], from[1], to[0], to[1])) {
+            if(window.contains(raster::row(pix), raster::col(pix))) {
+                visibles.set(raster::row(pix) - window.row_min, raster::col(pix) - window.col_min);
+            }
+        }
+    }
+    visibles.set(sensor_i - window.row_min, sensor_j - window.col_min);
+    return visibles.count();
+}
+
+} // geom
+} // ealain
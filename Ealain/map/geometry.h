@@ -0,0 +1,124 @@
+#ifndef __EALAIN_GEOMETRY_H__
+#define __EALAIN_GEOMETRY_H__
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "bits.h"
+#include "geom.h"
+#include "instance.h"
+#include "shared.h"
+#include "projection.h"
+
+namespace ealain {
+
+    namespace inst {
+
+        // Point in real-world coordinates: {x,y}.
+        using Vertex = std::array<double,2>;
+
+        struct Segment
+        {
+            Vertex from;
+            Vertex to;
+        };
+
+        // Closed polygon, its last vertex being linked to the first one.
+        using Polygon = std::vector<Vertex>;
+
+        /** Walls given as vector geometry, in real-world coordinates.
+         *
+         * Independent of any discretisation: walls are rasterized on demand into a map of any size,
+         * segments with raster::pixels_line, polygons filled with raster::poly::rasterize and outlined.
+         * Geometry out of the real-world ranges of the projection is clipped.
+         */
+        class Geometry
+        {
+            protected:
+                std::vector<Segment> _segments;
+                std::vector<Polygon> _polygons;
+
+            public:
+                void add(const Segment& segment);
+
+                // Polygon of at least three vertices.
+                void add(const Polygon& polygon);
+
+                const std::vector<Segment>& segments() const;
+                const std::vector<Polygon>& polygons() const;
+
+                // True if there are no walls.
+                bool empty() const;
+
+                /** Set the pixels of the walls to 1 in the given map, with the given linear projection.
+                 *
+                 * Other pixels are left as is.
+                 */
+                void rasterize(Map& map, const proj::Projection<double,size_t>& p) const;
+
+                // Same, setting the bits of the walls.
+                void rasterize(domain::Bits& walls, const proj::Projection<double,size_t>& p) const;
+        };
+
+        /** Read walls from a text file, one wall per line:
+         *
+         *     segment x0 y0 x1 y1
+         *     polygon x0 y0 x1 y1 x2 y2 …
+         *
+         * Blank lines and lines starting with # are ignored,
+         * malformed lines are reported on the error output and skipped.
+         * Throws std::runtime_error if the file cannot be read.
+         */
+        Geometry load_geometry(const std::string& filename);
+
+        // Write walls in the format read by load_geometry, throws std::runtime_error if the file cannot be written.
+        void save_geometry(const std::string& filename, const Geometry& geometry);
+
+        // Generate a rectangle map, rasterizing the walls of the given geometry.
+        std::pair<Map,proj::Projection<double,size_t>> rectangle_geometry(const Geometry& geometry,
+                size_t size_i, size_t size_j, double size_x, double size_y);
+
+        std::pair<Map,proj::Projection<double,size_t>> rectangle_geometry(const Geometry& geometry,
+                size_t max_i, size_t max_j, double min_x, double max_x, double min_y, double max_y);
+
+        /** Shared instance of the given geometry, rasterized straight into its bit-packed walls.
+         *
+         * The instance keeps the geometry, for the analytic visibility engine.
+         * The dense map is only built if asked for (see Instance::map).
+         * cache_budget bytes of visibility maps shared by the sensors, 0 meaning no cache.
+         */
+        Shared share(const Geometry& geometry, const proj::Projection<double,size_t>& p, size_t cache_budget = 0,
+                geom::Visibility engine = geom::Visibility::sweep);
+
+    } // inst
+
+    namespace geom {
+
+        /** Visibility polygon from the eye, within the given real-world bounds, which should contain it.
+         *
+         * Segments and polygons edges block the sight, as zero-width walls.
+         * Computed by an angular sweep: rays are cast toward each wall end (and slightly aside of it),
+         * in angular order, each one stopping on the nearest wall.
+         * The cost does not depend on the discretisation, but each of the 6·W rays is tested against
+         * all the W walls within the bounds: O(W²), fine for up to a few hundred walls per window.
+         * Empty if the eye is on a wall or inside a polygon.
+         */
+        inst::Polygon visibility_polygon(const inst::Geometry& geometry, const inst::Vertex& eye,
+                const inst::Vertex& min, const inst::Vertex& max);
+
+        /** Visibility map from pixel (sensor_i,sensor_j), only covering the given window, which should contain it.
+         *
+         * The eye is at the real-world coordinates of the sensor pixel,
+         * and pixels are classified by rasterizing its visibility polygon within the window.
+         * Pixel (i,j) is stored at (i-window.row_min, j-window.col_min), visibles being empty beforehand.
+         * Returns the number of visible pixels.
+         */
+        unsigned int visibility_map_2D(domain::Bits& visibles, const inst::Geometry& geometry,
+                const proj::Projection<double,size_t>& p, const int sensor_i, const int sensor_j, const Box& window);
+
+    } // geom
+
+} // ealain
+
+#endif // __EALAIN_GEOMETRY_H__
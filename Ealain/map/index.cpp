@@ -0,0 +1,297 @@
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EALAIN_INDEX_MMAP
+#endif
+
+#include "../utils.h"
+#include "index.h"
+
+namespace ealain {
+namespace geom {
+
+namespace {
+
+const char magic[8] = {'E','A','L','V','I','S','0','1'};
+
+// Number of uint64 words in the header.
+const size_t header_words = 3;
+
+// Record of the visibility map from the given cell, as uint64 words, empty if nothing is visible.
+std::vector<uint64_t> make_record(const inst::Map& map, size_t si, size_t sj)
+{
+    std::vector<uint64_t> record;
+    if(map[si][sj] == 1) {
+        return record;
+    }
+    domain::PlanT<char> visibles(map.size(), map[0].size(), 0);
+    visibility_map_2D_ray_tracing(visibles, map, si, sj);
+
+    // Bounding box of the visible pixels.
+    uint32_t box[4] = {UINT32_MAX, UINT32_MAX, 0, 0};
+    bool any = false;
+    for(size_t i=0; i < map.size(); ++i) {
+        for(size_t j=0; j < map[0].size(); ++j) {
+            if(visibles(i,j)) {
+                any = true;
+                box[0] = std::min<uint32_t>(box[0], i);
+                box[1] = std::min<uint32_t>(box[1], j);
+                box[2] = std::max<uint32_t>(box[2], i);
+                box[3] = std::max<uint32_t>(box[3], j);
+            }
+        }
+    }
+    if(not any) {
+        return record;
+    }
+    const size_t width = box[3] - box[1] + 1;
+    const size_t bits = (box[2] - box[0] + 1) * width;
+    record.assign(2 + (bits + 63) / 64, 0);
+    std::memcpy(record.data(), box, sizeof(box));
+    uint64_t* words = record.data() + 2;
+    for(size_t i = box[0]; i <= box[2]; ++i) {
+        for(size_t j = box[1]; j <= box[3]; ++j) {
+            if(visibles(i,j)) {
+                const size_t bit = (i - box[0]) * width + (j - box[1]);
+                words[bit / 64] |= uint64_t(1) << (bit % 64);
+            }
+        }
+    }
+    return record;
+}
+
+// Error about the given index file.
+std::runtime_error error(const std::string& filename, const std::string& what)
+{
+    return std::runtime_error(filename + ": " + what);
+}
+
+// Unmap (or free) the content of an index file.
+void release(const char* file, size_t bytes)
+{
+#ifdef EALAIN_INDEX_MMAP
+    munmap(const_cast<char*>(file), bytes);
+#else
+    (void)bytes;
+    ::operator delete(const_cast<char*>(file), std::align_val_t(alignof(uint64_t)));
+#endif
+}
+
+} // anonymous
+
+void VisibilityIndex::build(const inst::Map& map, const std::string& filename, size_t threads)
+{
+    assert(map.size() > 0);
+    assert(map[0].size() > 0);
+    const size_t rows = map.size();
+    const size_t cols = map[0].size();
+    const size_t sources = rows * cols;
+    if(threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if(not out.is_open()) {
+        throw error(filename, std::string("cannot write the visibility index: ") + std::strerror(errno));
+    }
+    const uint64_t sizes[2] = {rows, cols};
+    out.write(magic, sizeof(magic));
+    out.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+
+    // Offsets are known once all the records are written, reserve their space.
+    std::vector<uint64_t> offsets(sources + 1, 0);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+    // Compute records by chunks, so that memory does not grow with the map.
+    const size_t chunk = threads * 64;
+    std::vector<std::vector<uint64_t>> records(chunk);
+    uint64_t offset = 0;
+    for(size_t first = 0; first < sources; first += chunk) {
+        const size_t last = std::min(first + chunk, sources);
+        std::atomic<size_t> next(first);
+        std::vector<std::thread> workers;
+        for(size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                for(size_t s = next++; s < last; s = next++) {
+                    records[s - first] = make_record(map, s / cols, s % cols);
+                }
+            });
+        }
+        for(auto& worker : workers) {
+            worker.join();
+        }
+        for(size_t s = first; s < last; ++s) {
+            const auto& record = records[s - first];
+            offsets[s] = offset;
+            out.write(reinterpret_cast<const char*>(record.data()), record.size() * sizeof(uint64_t));
+            offset += record.size() * sizeof(uint64_t);
+        }
+    }
+    offsets[sources] = offset;
+
+    out.seekp(header_words * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.flush();
+    if(not out.good()) {
+        throw error(filename, "cannot write the visibility index");
+    }
+}
+
+VisibilityIndex::VisibilityIndex(const std::string& filename)
+{
+#ifdef EALAIN_INDEX_MMAP
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw error(filename, std::string("cannot open the visibility index: ") + std::strerror(errno));
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        const int code = errno;
+        close(fd);
+        throw error(filename, std::string("cannot read the visibility index: ") + std::strerror(code));
+    }
+    if(static_cast<size_t>(st.st_size) < header_words * sizeof(uint64_t)) {
+        close(fd);
+        throw error(filename, "not a visibility index");
+    }
+    _bytes = st.st_size;
+    void* mapped = mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+        throw error(filename, std::string("cannot map the visibility index: ") + std::strerror(errno));
+    }
+    _file = static_cast<const char*>(mapped);
+#else
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if(not in.is_open()) {
+        throw error(filename, "cannot open the visibility index");
+    }
+    _bytes = in.tellg();
+    char* file = static_cast<char*>(::operator new(_bytes, std::align_val_t(alignof(uint64_t))));
+    in.seekg(0);
+    in.read(file, _bytes);
+    _file = file;
+    if(not in) {
+        release(_file, _bytes);
+        throw error(filename, "cannot read the visibility index");
+    }
+#endif
+    // The destructor is not called when the constructor throws.
+    auto reject = [this, &filename](const std::string& what) {
+        release(_file, _bytes);
+        return error(filename, what);
+    };
+
+    if(_bytes < header_words * sizeof(uint64_t) or std::memcmp(_file, magic, sizeof(magic)) != 0) {
+        throw reject("not a visibility index");
+    }
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(_file);
+    _rows = header[1];
+    _cols = header[2];
+    // Number of words left for the offsets, so that their number cannot overflow.
+    const size_t words = _bytes / sizeof(uint64_t) - header_words;
+    if(_rows == 0 or _cols == 0 or _rows >= words or _cols >= words / _rows) {
+        throw reject("truncated visibility index");
+    }
+    const size_t sources = _rows * _cols;
+    _offsets = header + header_words;
+    _records = reinterpret_cast<const char*>(_offsets + sources + 1);
+
+    // Records follow each other up to the end of the file, their content is checked when read.
+    const size_t records = _file + _bytes - _records;
+    if(_offsets[0] != 0 or _offsets[sources] != records) {
+        throw reject("truncated visibility index");
+    }
+    for(size_t s=0; s < sources; ++s) {
+        if(_offsets[s+1] < _offsets[s] or _offsets[s+1] % sizeof(uint64_t) != 0) {
+            throw reject("corrupt offsets in the visibility index");
+        }
+    }
+}
+
+VisibilityIndex::~VisibilityIndex()
+{
+    release(_file, _bytes);
+}
+
+const uint32_t* VisibilityIndex::record(size_t si, size_t sj) const
+{
+    assert(si < _rows and sj < _cols);
+    const size_t s = si * _cols + sj;
+    const size_t bytes = _offsets[s+1] - _offsets[s];
+    if(bytes == 0) {
+        return nullptr;
+    }
+    // The box should be within the map, and its bitset should fill the record.
+    const uint32_t* box = reinterpret_cast<const uint32_t*>(_records + _offsets[s]);
+    if(bytes < 2 * sizeof(uint64_t) or box[0] > box[2] or box[2] >= _rows or box[1] > box[3] or box[3] >= _cols
+       or bytes != (2 + (size_t(box[2] - box[0] + 1) * (box[3] - box[1] + 1) + 63) / 64) * sizeof(uint64_t)) {
+        throw std::runtime_error("corrupt record in the visibility index");
+    }
+    return box;
+}
+
+bool VisibilityIndex::operator()(size_t si, size_t sj, size_t i, size_t j) const
+{
+    const uint32_t* box = record(si, sj);
+    if(not box or i < box[0] or i > box[2] or j < box[1] or j > box[3]) {
+        return false;
+    }
+    const uint64_t* words = reinterpret_cast<const uint64_t*>(box + 4);
+    const size_t bit = (i - box[0]) * (box[3] - box[1] + 1) + (j - box[1]);
+    return (words[bit / 64] >> (bit % 64)) & 1;
+}
+
+// Call set(row,col) on the pixels of the window set in the given record, in window coordinates.
+template<class Set>
+static unsigned int fill_window(const uint32_t* box, const Box& window, Set set)
+{
+    if(not box) {
+        return 0;
+    }
+    const uint64_t* words = reinterpret_cast<const uint64_t*>(box + 4);
+    const size_t width = box[3] - box[1] + 1;
+    const size_t row_min = std::max<size_t>(box[0], window.row_min);
+    const size_t row_max = std::min<size_t>(box[2], window.row_max);
+    const size_t col_min = std::max<size_t>(box[1], window.col_min);
+    const size_t col_max = std::min<size_t>(box[3], window.col_max);
+
+    unsigned int counter = 0;
+    for(size_t i = row_min; i <= row_max and col_min <= col_max; ++i) {
+        for(size_t j = col_min; j <= col_max; ++j) {
+            const size_t bit = (i - box[0]) * width + (j - box[1]);
+            if((words[bit / 64] >> (bit % 64)) & 1) {
+                set(i - window.row_min, j - window.col_min);
+                counter++;
+            }
+        }
+    }
+    return counter;
+}
+
+unsigned int VisibilityIndex::fill(domain::PlanT<char>& visibles, size_t si, size_t sj, const Box& window) const
+{
+    assert(visibles.buffer().sizes() == (std::array<size_t,2>{window.rows(), window.cols()}));
+    visibles.buffer().fill(0);
+    return fill_window(record(si, sj), window, [&visibles](size_t i, size_t j) {visibles(i, j) = 1;});
+}
+
+unsigned int VisibilityIndex::fill(domain::Bits& visibles, size_t si, size_t sj, const Box& window) const
+{
+    assert(visibles.rows() == window.rows() and visibles.cols() == window.cols());
+    visibles.fill(false);
+    return fill_window(record(si, sj), window, [&visibles](size_t i, size_t j) {visibles.set(i, j);});
+}
+
+} // geom
+} // ealain
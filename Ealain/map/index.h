@@ -0,0 +1,85 @@
+#ifndef __EALAIN_INDEX_H__
+#define __EALAIN_INDEX_H__
+
+#include <cstdint>
+#include <string>
+
+#include "plan.h"
+#include "bits.h"
+#include "geom.h"
+#include "instance.h"
+
+namespace ealain {
+
+    namespace geom {
+
+        /** Precomputed visibility maps from every cell of a map, stored on disk.
+         *
+         * An index is built once per map (see build), then memory-mapped,
+         * so that visibility from any cell is read instead of traced.
+         *
+         * File format, in native byte order:
+         *   - magic "EALVIS01", number of rows and columns (uint64),
+         *   - rows×cols+1 offsets (uint64) of the records, relative to the first one,
+         *     in row-major order of the source cells,
+         *   - records: the bounding box of the visible pixels (4 × uint32: row_min, col_min, row_max, col_max),
+         *     then a bitset of that box in row-major order, packed in uint64 words.
+         * Empty records (walls, as nothing is seen from them) take no space.
+         */
+        class VisibilityIndex
+        {
+            protected:
+                // Whole mapped file.
+                const char* _file;
+                size_t _bytes;
+
+                size_t _rows;
+                size_t _cols;
+                const uint64_t* _offsets;
+                const char* _records;
+
+                // Record of the given source cell, nullptr if nothing is visible from it.
+                const uint32_t* record(size_t si, size_t sj) const;
+
+            public:
+                /** Compute the visibility map from every non-wall cell of the map and write the index to the given file.
+                 *
+                 * threads number of threads computing maps, 0 means the hardware concurrency.
+                 * The file does not depend on the number of threads.
+                 * Throws std::runtime_error if the file cannot be written.
+                 */
+                static void build(const inst::Map& map, const std::string& filename, size_t threads = 0);
+
+                /** Memory-map the given index file.
+                 *
+                 * Throws std::runtime_error if the file cannot be read or is not a well-formed index,
+                 * records being checked when read.
+                 */
+                VisibilityIndex(const std::string& filename);
+
+                VisibilityIndex(const VisibilityIndex&) = delete;
+                VisibilityIndex& operator=(const VisibilityIndex&) = delete;
+
+                ~VisibilityIndex();
+
+                size_t rows() const {return _rows;}
+                size_t cols() const {return _cols;}
+
+                // True if pixel (i,j) is visible from cell (si,sj), in constant time.
+                bool operator()(size_t si, size_t sj, size_t i, size_t j) const;
+
+                /** Set the pixels of the window visible from cell (si,sj), returns their number.
+                 *
+                 * Same as visibility_map_2D_ray_tracing on the window with overwrite: pixel (i,j) is at (i-row_min, j-col_min).
+                 */
+                unsigned int fill(domain::PlanT<char>& visibles, size_t si, size_t sj, const Box& window) const;
+
+                // Same as above, in a bit-packed map.
+                unsigned int fill(domain::Bits& visibles, size_t si, size_t sj, const Box& window) const;
+        };
+
+    } // geom
+
+} // ealain
+
+#endif // __EALAIN_INDEX_H__
@@ -7,6 +7,13 @@
 #include <tuple>
 #include <numeric>
 #include <ctime>
+#include <charconv>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
 
 #include "../utils.h"
 #include "instance.h"
@@ -14,7 +21,165 @@
 
 namespace ealain {
 namespace inst {
-std::pair<Map,proj::Projection<double,size_t>> rectangle(
+
+namespace {
+
+// Bytes of a csv file of walls read at once.
+const size_t chunk_bytes = size_t(1) << 22;
+
+// Minimum bytes parsed by a thread.
+const size_t slice_bytes = size_t(1) << 16;
+
+// Malformed lines printed, the others are only counted.
+const size_t reported_lines = 10;
+
+const char* skip_blanks(const char* first, const char* last)
+{
+    while(first != last and (*first == ' ' or *first == '\t' or *first == '\r')) {
+        ++first;
+    }
+    return first;
+}
+
+// Parse a number and the separator after it, if any, moving first past them.
+template<class T>
+bool field(const char*& first, const char* last, T& value)
+{
+    const std::from_chars_result parsed = std::from_chars(skip_blanks(first, last), last, value);
+    if(parsed.ec != std::errc()) {
+        return false;
+    }
+    first = skip_blanks(parsed.ptr, last);
+    if(first != last and *first == ',') {
+        first++;
+    }
+    return true;
+}
+
+// Walls and malformed lines found in a part of a chunk.
+struct Slice
+{
+    std::vector<std::pair<size_t,size_t>> walls;
+    // Number of lines of the slice.
+    size_t lines;
+    // Line (in the slice) and content of the first malformed lines.
+    std::vector<std::pair<size_t,std::string>> malformed;
+    size_t malformed_count;
+};
+
+// Parse the lines in [first,last), which ends with a whole line.
+template<class Parse>
+void parse_slice(const char* first, const char* last, Parse& parse, Slice& slice)
+{
+    slice.walls.clear();
+    slice.malformed.clear();
+    slice.lines = 0;
+    slice.malformed_count = 0;
+    while(first != last) {
+        const char* end = std::find(first, last, '\n');
+        const char* content = skip_blanks(first, end);
+        size_t i, j;
+        if(content != end) {
+            if(parse(first, end, i, j)) {
+                slice.walls.emplace_back(i, j);
+            } else {
+                if(slice.malformed.size() < reported_lines) {
+                    slice.malformed.emplace_back(slice.lines, std::string(first, end));
+                }
+                slice.malformed_count++;
+            }
+        }
+        slice.lines++;
+        first = end == last ? last : end + 1;
+    }
+}
+
+/** Set to 1 the cells of the map given by each line of a csv file.
+ *
+ * parse(first, last, i, j) reads the cell of the line [first,last), returning false if malformed.
+ * The file is read by chunks, the lines of a chunk being parsed across threads.
+ * Malformed lines are skipped and reported on the error output, blank lines are ignored.
+ * An empty filename gives no walls, a file that cannot be opened or read throws std::runtime_error.
+ */
+template<class Parse>
+void load_walls(const std::string& filename, Map& map, Parse parse)
+{
+    if(filename.empty()) {
+        return;
+    }
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if(not file.is_open()) {
+        throw std::runtime_error(filename + ": cannot open the walls: " + std::strerror(errno));
+    }
+    const size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<Slice> slices(threads);
+    std::vector<char> buffer;
+    // Bytes of an incomplete line at the front of the buffer, left from the previous chunk.
+    size_t carried = 0;
+    // Lines before the current chunk.
+    size_t lines = 0;
+    size_t malformed = 0;
+    bool end = false;
+    while(not end) {
+        buffer.resize(carried + chunk_bytes);
+        file.read(buffer.data() + carried, chunk_bytes);
+        const size_t size = carried + file.gcount();
+        if(file.bad()) {
+            throw std::runtime_error(filename + ": cannot read the walls");
+        }
+        end = not file;
+
+        // Only whole lines are parsed, the last one is carried to the next chunk.
+        size_t whole = size;
+        if(not end) {
+            const auto newline = std::find(std::make_reverse_iterator(buffer.begin() + size), buffer.rend(), '\n');
+            whole = newline.base() - buffer.begin();
+        }
+        const char* data = buffer.data();
+
+        // Split at line boundaries.
+        const size_t used = std::min(threads, whole / slice_bytes + 1);
+        std::vector<size_t> bounds(used + 1, whole);
+        bounds[0] = 0;
+        for(size_t t=1; t < used; ++t) {
+            const char* at = std::find(data + std::max(bounds[t-1], t * whole / used), data + whole, '\n');
+            bounds[t] = at == data + whole ? whole : at - data + 1;
+        }
+        std::vector<std::thread> workers;
+        for(size_t t=1; t < used; ++t) {
+            workers.emplace_back([&, t]() {
+                parse_slice(data + bounds[t], data + bounds[t+1], parse, slices[t]);
+            });
+        }
+        parse_slice(data + bounds[0], data + bounds[1], parse, slices[0]);
+        for(auto& worker : workers) {
+            worker.join();
+        }
+
+        for(size_t t=0; t < used; ++t) {
+            for(const auto& ij : slices[t].walls) {
+                map[ij.first][ij.second] = 1;
+            }
+            for(const auto& line : slices[t].malformed) {
+                if(malformed < reported_lines) {
+                    std::cerr << filename << ":" << lines + line.first + 1 << ": malformed wall \"" << line.second << "\"" << std::endl;
+                }
+                malformed++;
+            }
+            malformed += slices[t].malformed_count - slices[t].malformed.size();
+            lines += slices[t].lines;
+        }
+
+        std::copy(buffer.begin() + whole, buffer.begin() + size, buffer.begin());
+        carried = size - whole;
+    }
+    if(malformed > 0) {
+        std::cerr << filename << ": " << malformed << " malformed lines skipped" << std::endl;
+    }
+}
+
+} // anonymous
+proj::Projection<double,size_t> rectangle_projection(
         size_t max_i,
         size_t max_j,
         double min_x, double max_x,
@@ -35,6 +200,17 @@ std::pair<Map,proj::Projection<double,size_t>> rectangle(
 
     proj::Projection<double,size_t> p_map = proj::Projection<double,size_t>({lm1,lm2});
 
+    return p_map;
+}
+
+std::pair<Map,proj::Projection<double,size_t>> rectangle(
+        size_t max_i,
+        size_t max_j,
+        double min_x, double max_x,
+        double min_y, double max_y)
+{
+    proj::Projection<double,size_t> p_map = rectangle_projection(max_i, max_j, min_x, max_x, min_y, max_y);
+
     Map map = Map(max_i, std::vector<double>(max_j));
     return {map,p_map};
 }
@@ -52,36 +228,22 @@ std::pair<Map,proj::Projection<double,size_t>> rectangle_walls(
         double min_y, double max_y)
 {
     // Projection
-    assert(max_x > min_x);
-    assert(max_y > min_y);
-    proj::Range<double> range_x(min_x,max_x);
-    proj::Range<double> range_y(min_y,max_y);
-    proj::Range<size_t> range_i(0,max_i-1);
-    proj::Range<size_t> range_j(0,max_j-1);
-
-    std::shared_ptr<proj::Proj<double,size_t>> lm1
-     = std::make_shared<proj::Linear<double,size_t>>(range_x,range_i); // Mapping from x to i
-
-    std::shared_ptr<proj::Proj<double,size_t>> lm2
-     = std::make_shared<proj::Linear<double,size_t>>(range_y,range_j); // Mapping from y to j
-
-    proj::Projection<double,size_t> p_map = proj::Projection<double,size_t>({lm1,lm2});
+    proj::Projection<double,size_t> p_map = rectangle_projection(max_i, max_j, min_x, max_x, min_y, max_y);
 
     // Load file and create domain
     Map map = Map(max_i, std::vector<double>(max_j,0)); // Set everything to 0 = can be seen
-    std::vector<int> row;
-    std::string line, word;
-    std::fstream file (filename, std::ios::in);
-    while(getline(file, line))
-    {
-        row.clear();
-        std::stringstream str(line);
-        while(getline(str, word, ','))
-        {
-            row.push_back(stoi(word));
+    load_walls(filename, map, [&](const char* first, const char* last, size_t& i, size_t& j) {
+        long row, col;
+        if(not field(first, last, row) or not field(first, last, col) or first != last) {
+            return false;
         }
-        map[row[0]][row[1]] = 1;
-    }
+        if(row < 0 or col < 0 or static_cast<size_t>(row) >= max_i or static_cast<size_t>(col) >= max_j) {
+            return false;
+        }
+        i = row;
+        j = col;
+        return true;
+    });
 
     return {map,p_map};
 }
@@ -94,53 +256,25 @@ std::pair<Map,proj::Projection<double,size_t>> rectangle_walls_numeric(
         double min_y, double max_y)
 {
     // Projection
-    assert(max_x > min_x);
-    assert(max_y > min_y);
-    proj::Range<double> range_x(min_x,max_x);
-    proj::Range<double> range_y(min_y,max_y);
-    proj::Range<size_t> range_i(0,max_i-1);
-    proj::Range<size_t> range_j(0,max_j-1);
-
-    std::shared_ptr<proj::Proj<double,size_t>> lm1
-     = std::make_shared<proj::Linear<double,size_t>>(range_x,range_i); // Mapping from x to i
-
-    std::shared_ptr<proj::Proj<double,size_t>> lm2
-     = std::make_shared<proj::Linear<double,size_t>>(range_y,range_j); // Mapping from y to j
-
-    proj::Projection<double,size_t> p_map = proj::Projection<double,size_t>({lm1,lm2});
+    proj::Projection<double,size_t> p_map = rectangle_projection(max_i, max_j, min_x, max_x, min_y, max_y);
 
     // Load file and create domain
     Map map = Map(max_i, std::vector<double>(max_j,0)); // Set everything to 0 = can be seen
-    std::vector<size_t> row;
-    std::string line, word;
-    std::fstream file (filename, std::ios::in);
-    std::vector<double> xy;
-    int count = 0;
-    while(getline(file, line))
-    {
-        row.clear();
-        xy.clear();
-        std::stringstream str(line);
-        while(getline(str, word, ','))
-        {
-            if (count == 0)
-            {
-                xy.push_back(max_x*stof(word)+min_x);
-                count += 1;
-            }
-            else
-            {
-                xy.push_back(max_y*stof(word)+min_y);
-                count = 0;
-            }
-
+    load_walls(filename, map, [&](const char* first, const char* last, size_t& i, size_t& j) {
+        // Parsed as float, as always.
+        float u, v;
+        if(not field(first, last, u) or not field(first, last, v) or first != last) {
+            return false;
         }
-        row = p_map(xy);
-        std::cout<< xy[0] << " : " << xy[1] << std::endl;
-        std::cout<< row[0] << " : " << row[1] << std::endl;
-        std::cout<< "-----------" << std::endl;
-        map[row[0]][row[1]] = 1;
-    }
+        const double x = max_x*u+min_x;
+        const double y = max_y*v+min_y;
+        if(not (x >= min_x and x <= max_x and y >= min_y and y <= max_y)) {
+            return false;
+        }
+        i = p_map[0](x);
+        j = p_map[1](y);
+        return true;
+    });
 
     return {map,p_map};
 }
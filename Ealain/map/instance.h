@@ -16,6 +16,13 @@ namespace ealain {
 
         using Map = std::vector<std::vector<double>>;
 
+        // Linear projection of a rectangle map of max_i×max_j pixels over the given ranges.
+        proj::Projection<double,size_t> rectangle_projection(
+                size_t max_i,
+                size_t max_j,
+                double min_x, double max_x,
+                double min_y, double max_y);
+
         // Generate a rectangle map, with ranges starting at zero.
         std::pair<Map,proj::Projection<double,size_t>> rectangle(size_t size_i, size_t size_j, double size_x, double size_y);
 
@@ -27,6 +34,7 @@ namespace ealain {
                 double min_y, double max_y);
 
         // Generate a rectangle map, loading walls from a csv file of pixels coordiantes of walls.
+        // An empty filename gives no walls, a file that cannot be read throws std::runtime_error.
         std::pair<Map,proj::Projection<double,size_t>> rectangle_walls(std::string filename, size_t size_i, size_t size_j, double size_x, double size_y);
         std::pair<Map,proj::Projection<double,size_t>> rectangle_walls_numeric(std::string filename, size_t size_i, size_t size_j, double size_x, double size_y);
 
@@ -17,8 +17,9 @@ namespace ealain {
             public:
                 using iterator = Plan_iterator<T>;
                 using data_type = typename Domain<2,T>::data_type;
+                using nested_type = typename Domain<2,T>::nested_type;
 
-                PlanT( data_type data );
+                PlanT( const nested_type& data );
 
                 PlanT(std::size_t lines, std::size_t columns, T fill = 0);
 
@@ -41,18 +42,23 @@ namespace ealain {
 
         using Plan = PlanT<double>;
 
-        // An iterator over a whole Plan.
+        /** An iterator over a whole Plan.
+         *
+         * Walks the contiguous storage with a raw pointer,
+         * while keeping track of the current coordinates.
+         */
         template<typename T/*=double*/>
         class Plan_iterator : public std::iterator<std::bidirectional_iterator_tag, T>
         {
         protected:
-            PlanT<T>* _domain;
+            T* _cell;
+            std::size_t _columns;
             std::size_t _i_row;
             std::size_t _j_col;
 
             Plan_iterator(
-                    PlanT<T>* plan = nullptr,
-                    std::vector<std::size_t> coords = {0,0}
+                    PlanT<T>* plan,
+                    std::array<std::size_t,2> coords = {0,0}
                 );
 
         public:
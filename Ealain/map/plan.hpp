@@ -5,7 +5,7 @@ namespace domain {
 // Plan
 
 template<typename T>
-PlanT<T>::PlanT( data_type data ) : Domain<2,T>(data) {}
+PlanT<T>::PlanT( const nested_type& data ) : Domain<2,T>(data) {}
 
 template<typename T>
 PlanT<T>::PlanT(std::size_t lines, std::size_t columns, T fill) :
@@ -26,27 +26,25 @@ PlanT<T>::PlanT(proj::Projection<T,size_t> p, T fill) :
 template<typename T>
 T& PlanT<T>::at(std::vector<std::size_t> coords)
 {
-    return this->_data[ coords[0] ][ coords[1] ];
+    return this->_data( coords[0], coords[1] );
 }
 
 template<typename T>
 const T& PlanT<T>::at(std::vector<std::size_t> coords) const
 {
-    return this->_data[ coords[0] ][ coords[1] ];
+    return this->_data( coords[0], coords[1] );
 }
 
 template<typename T>
 std::size_t PlanT<T>::size() const
 {
-    assert(this->_data.size() > 0);
-    return this->_data.size() * this->_data.at(0).size();
+    return this->_data.size();
 }
 
 template<typename T>
 std::array<std::size_t,2> PlanT<T>::sizes() const
 {
-    assert(this->_data.size() > 0);
-    return { this->_data.size(), this->_data.at(0).size() };
+    return this->_data.sizes();
 }
 
 template<typename T>
@@ -66,14 +64,13 @@ typename PlanT<T>::iterator PlanT<T>::end()
 template<typename T>
 Plan_iterator<T>::Plan_iterator(
         PlanT<T>* plan,
-        std::vector<std::size_t> coords
+        std::array<std::size_t,2> coords
     ) :
-    _domain(plan),
-    _i_row(coords.at(0)),
-    _j_col(coords.at(1))
-{
-    assert(coords.size() == 2);
-}
+    _cell(plan->buffer().data() + coords[0] * plan->buffer().strides()[0] + coords[1]),
+    _columns(plan->buffer().sizes()[1]),
+    _i_row(coords[0]),
+    _j_col(coords[1])
+{ }
 
 template<typename T>
 Plan_iterator<T> Plan_iterator<T>::begin(PlanT<T>& plan) {
@@ -82,31 +79,28 @@ Plan_iterator<T> Plan_iterator<T>::begin(PlanT<T>& plan) {
 
 template<typename T>
 Plan_iterator<T> Plan_iterator<T>::end(PlanT<T>& plan) {
-    return Plan_iterator(&plan, {plan.data().size(), 0});
+    return Plan_iterator(&plan, {plan.buffer().sizes()[0], 0});
 }
 
 template<typename T>
 T& Plan_iterator<T>::operator*()
 {
-    return const_cast<T&>(static_cast<const PlanT<T>&>(*_domain).at({_i_row,_j_col}));
+    return *_cell;
 }
 
 template<typename T>
 const T& Plan_iterator<T>::operator*() const
 {
-    return _domain->at({_i_row,_j_col});
+    return *_cell;
 }
 
 template<typename T>
 Plan_iterator<T>& Plan_iterator<T>::operator++()
 {
-    if(_j_col + 1 < _domain->data()[_i_row].size()) {
-        _j_col++;
-    } else {
-        do {
-            _i_row++;
-        } while(_i_row < _domain->data().size() and _domain->data()[_i_row].empty());
-
+    // Rows are contiguous, the pointer only has to move forward.
+    ++_cell;
+    if(++_j_col == _columns) {
+        _i_row++;
         _j_col = 0;
     }
     return *this;
@@ -115,13 +109,12 @@ Plan_iterator<T>& Plan_iterator<T>::operator++()
 template<typename T>
 Plan_iterator<T>& Plan_iterator<T>::operator--()
 {
+    --_cell;
     if(_j_col > 0) {
         _j_col--;
     } else {
-        do {
-            _i_row--;
-        } while( _domain->data()[_i_row].empty());
-        _j_col = _domain->data()[_i_row].size() - 1;
+        _i_row--;
+        _j_col = _columns - 1;
     }
     return *this;
 }
@@ -145,9 +138,7 @@ Plan_iterator<T> Plan_iterator<T>::operator--(int)
 template<typename T>
 bool Plan_iterator<T>::operator==(const Plan_iterator<T>& other) const
 {
-    return other._domain  == _domain
-       and other._i_row   == _i_row
-       and other._j_col   == _j_col;
+    return other._cell == _cell;
 }
 
 template<typename T>
@@ -159,8 +150,8 @@ bool Plan_iterator<T>::operator!=(const Plan_iterator<T>& other) const
 template<typename T>
 std::size_t Plan_iterator<T>::operator()(std::size_t dimension) const
 {
-    std::array<std::size_t,2> coords = {_i_row,_j_col};
-    return coords[dimension];
+    assert(dimension < 2);
+    return dimension == 0 ? _i_row : _j_col;
 }
 
 } // domain
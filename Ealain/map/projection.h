@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <vector>
+#include <array>
 #include <memory>
 
 #include <cassert>
@@ -87,6 +88,12 @@ namespace proj {
 
            //Map from numerical space to discrete space.
            virtual IDX operator()(IRL x) const;
+
+           //Non-virtual version of the discrete to numerical mapping.
+           IRL irl(IDX x) const;
+
+           //Non-virtual version of the numerical to discrete mapping.
+           IDX idx(IRL x) const;
     };
 
     /** Interface for n-dimensional Projections.
@@ -99,6 +106,16 @@ namespace proj {
        protected:
            std::vector<std::shared_ptr<Proj<IRL,IDX>>> _projs;
 
+           //Non-owning pointers to the axes that are exactly Linear (nullptr otherwise),
+           //used to bypass virtual dispatch.
+           std::vector<const Linear<IRL,IDX>*> _linears;
+
+           //Map the index x of axis d to numerical space.
+           IRL apply(size_t d, IDX x) const;
+
+           //Map the coordinate x of axis d to discrete space.
+           IDX apply(size_t d, IRL x) const;
+
            /** Apply the ith-Projection to each ith-element in vx.
             *
             * Use the templates I/O to decide which Projection to apply.
@@ -149,6 +166,41 @@ namespace proj {
            //Map a set of vectors from numerical space to discrete space.
            virtual std::vector<std::vector<IDX>> operator()(std::vector<std::vector<IRL>> x) const;
 
+           //Map a fixed-size array from discrete space to numerical space, without allocation.
+           template<size_t N>
+           std::array<IRL,N> operator()(const std::array<IDX,N>& x) const;
+
+           //Map a fixed-size array from numerical space to discrete space, without allocation.
+           template<size_t N>
+           std::array<IDX,N> operator()(const std::array<IRL,N>& x) const;
+
+           /** Map n consecutive indices of axis d, starting at first, to numerical space.
+            *
+            * Results are written in the caller-provided buffer out, which should hold n items.
+            */
+           void axis(size_t d, IDX first, size_t n, IRL* out) const;
+
+           /** Lookup table of the numerical coordinates of the first n indices of axis d.
+            *
+            * Item i holds the numerical coordinate of index i.
+            */
+           std::vector<IRL> axis(size_t d, size_t n) const;
+
+           //Map the index x of axis d to numerical space, without virtual dispatch on Linear axes.
+           IRL irl(size_t d, IDX x) const {return apply(d, x);}
+
+           //Map the coordinate x of axis d to discrete space, without virtual dispatch on Linear axes.
+           IDX idx(size_t d, IRL x) const {return apply(d, x);}
+
+           //True if all axes are Linear, in which case no mapping goes through virtual dispatch.
+           bool is_linear() const;
+
+           /** True if both projections are known to map the same indices to the same coordinates.
+            *
+            * That is, each axis is either the same Proj, or Linear on both, with the same ranges.
+            */
+           bool matches(const Projection<IRL,IDX>& other) const;
+
            //Accessor to the Proj used for dimension d.
            const Proj<IRL,IDX>& operator[](size_t d) const;
 
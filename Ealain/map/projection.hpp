@@ -1,5 +1,8 @@
 #include <memory>
 #include <cmath>
+#include <typeinfo>
+
+#include "../trace.h"
 
 
 namespace ealain {
@@ -55,6 +58,18 @@ Linear<IRL,IDX>::Linear(Range<IRL> range_irl, Range<IDX> range_idx) : Proj<IRL,I
 
 template<class IRL, class IDX>
 IRL Linear<IRL,IDX>::operator()(IDX x) const
+{
+    return this->irl(x);
+}
+
+template<class IRL, class IDX>
+IDX Linear<IRL,IDX>::operator()(IRL x) const
+{
+    return this->idx(x);
+}
+
+template<class IRL, class IDX>
+IRL Linear<IRL,IDX>::irl(IDX x) const
 {
     double normalized = (static_cast<IRL>(x)
           - static_cast<IRL>(this->_range_idx.min()))
@@ -68,7 +83,7 @@ IRL Linear<IRL,IDX>::operator()(IDX x) const
 }
 
 template<class IRL, class IDX>
-IDX Linear<IRL,IDX>::operator()(IRL x) const
+IDX Linear<IRL,IDX>::idx(IRL x) const
 {
     double normalized = ((x
           - this->_range_irl.min())
@@ -94,15 +109,44 @@ Projection<IRL,IDX>::Projection()
 
 template<class IRL, class IDX>
 Projection<IRL,IDX>::Projection(std::vector<std::shared_ptr<Proj<IRL,IDX>>> norms )
-    : _projs(norms)
 {
-    assert(_projs.size() > 0);
+    assert(norms.size() > 0);
+    for(auto& p : norms) {
+        this->add(p);
+    }
 }
 
 template<class IRL, class IDX>
 void Projection<IRL,IDX>::add(std::shared_ptr<Proj<IRL,IDX>> proj)
 {
     _projs.push_back(proj);
+    // Only exact Linear instances can be devirtualized,
+    // derived classes may have overloaded the mapping.
+    if(typeid(*proj) == typeid(Linear<IRL,IDX>)) {
+        _linears.push_back(static_cast<const Linear<IRL,IDX>*>(proj.get()));
+    } else {
+        _linears.push_back(nullptr);
+    }
+}
+
+template<class IRL, class IDX>
+IRL Projection<IRL,IDX>::apply(size_t d, IDX x) const
+{
+    if(_linears[d]) {
+        return _linears[d]->irl(x);
+    } else {
+        return (*(_projs[d]))(x);
+    }
+}
+
+template<class IRL, class IDX>
+IDX Projection<IRL,IDX>::apply(size_t d, IRL x) const
+{
+    if(_linears[d]) {
+        return _linears[d]->idx(x);
+    } else {
+        return (*(_projs[d]))(x);
+    }
 }
 
 
@@ -115,7 +159,7 @@ std::vector<O> Projection<IRL,IDX>::proj(std::vector<I> vx) const
     assert(vx.size() > 0);
     assert(vx.size() == _projs.size());
     for(unsigned int i=0; i < vx.size(); ++i) {
-        result.push_back( (*(_projs[i]))(vx[i]) );
+        result.push_back( this->apply(i, vx[i]) );
     }
     return result;
 }
@@ -156,6 +200,90 @@ std::vector<std::vector<IRL>> Projection<IRL,IDX>::operator()(std::vector<std::v
     return this->proj<IDX,IRL>(d);
 }
 
+template<class IRL, class IDX>
+template<size_t N>
+std::array<IRL,N> Projection<IRL,IDX>::operator()(const std::array<IDX,N>& x) const
+{
+    assert(N == _projs.size());
+    std::array<IRL,N> y;
+    for(size_t i=0; i < N; ++i) {
+        y[i] = this->apply(i, x[i]);
+    }
+    return y;
+}
+
+template<class IRL, class IDX>
+template<size_t N>
+std::array<IDX,N> Projection<IRL,IDX>::operator()(const std::array<IRL,N>& x) const
+{
+    assert(N == _projs.size());
+    std::array<IDX,N> y;
+    for(size_t i=0; i < N; ++i) {
+        y[i] = this->apply(i, x[i]);
+    }
+    return y;
+}
+
+template<class IRL, class IDX>
+void Projection<IRL,IDX>::axis(size_t d, IDX first, size_t n, IRL* out) const
+{
+    assert(d < _projs.size());
+    EALAIN_TRACE(projection, n);
+    if(_linears[d]) {
+        const Linear<IRL,IDX>& lin = *_linears[d];
+        for(size_t i=0; i < n; ++i) {
+            out[i] = lin.irl(static_cast<IDX>(first + i));
+        }
+    } else {
+        const Proj<IRL,IDX>& proj = *_projs[d];
+        for(size_t i=0; i < n; ++i) {
+            out[i] = proj(static_cast<IDX>(first + i));
+        }
+    }
+}
+
+template<class IRL, class IDX>
+std::vector<IRL> Projection<IRL,IDX>::axis(size_t d, size_t n) const
+{
+    std::vector<IRL> table(n);
+    this->axis(d, 0, n, table.data());
+    return table;
+}
+
+template<class IRL, class IDX>
+bool Projection<IRL,IDX>::is_linear() const
+{
+    for(const auto& l : _linears) {
+        if(not l) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<class IRL, class IDX>
+bool Projection<IRL,IDX>::matches(const Projection<IRL,IDX>& other) const
+{
+    if(_projs.size() != other._projs.size()) {
+        return false;
+    }
+    for(size_t d=0; d < _projs.size(); ++d) {
+        if(_projs[d] == other._projs[d]) {
+            continue;
+        }
+        const Linear<IRL,IDX>* mine = _linears[d];
+        const Linear<IRL,IDX>* theirs = other._linears[d];
+        if(not mine or not theirs
+           or mine->range_irl().min() != theirs->range_irl().min()
+           or mine->range_irl().max() != theirs->range_irl().max()
+           or mine->range_idx().min() != theirs->range_idx().min()
+           or mine->range_idx().max() != theirs->range_idx().max()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template<class IRL, class IDX>
 const Proj<IRL,IDX>& Projection<IRL,IDX>::operator[](size_t d) const
 {
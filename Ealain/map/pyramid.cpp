@@ -0,0 +1,188 @@
+#include <array>
+#include <memory>
+#include <algorithm>
+
+#include "../utils.h"
+#include "pyramid.h"
+
+namespace ealain {
+namespace inst {
+
+// Linear projection of the given real-world ranges on a rows×cols grid.
+static proj::Projection<double,size_t> scaled(const proj::Projection<double,size_t>& p, size_t rows, size_t cols)
+{
+    std::shared_ptr<proj::Proj<double,size_t>> li
+        = std::make_shared<proj::Linear<double,size_t>>(p[0].range_irl(), proj::Range<size_t>(0, rows-1));
+    std::shared_ptr<proj::Proj<double,size_t>> lj
+        = std::make_shared<proj::Linear<double,size_t>>(p[1].range_irl(), proj::Range<size_t>(0, cols-1));
+    return proj::Projection<double,size_t>({li, lj});
+}
+
+Pyramid::Pyramid(const Map& map, const proj::Projection<double,size_t>& p, size_t levels)
+{
+    assert(levels > 0);
+    assert(map.size() > 0 and map[0].size() > 0);
+    assert(p.size() == 2);
+    _levels.push_back(Level{map, p, geom::walls(map)});
+
+    while(_levels.size() < levels) {
+        const domain::Bits& fine = _levels.back().walls;
+        if(fine.rows() == 1 and fine.cols() == 1) {
+            break;
+        }
+        const size_t rows = (fine.rows() + 1) / 2;
+        const size_t cols = (fine.cols() + 1) / 2;
+        domain::Bits coarse(rows, cols);
+        for(size_t i=0; i < fine.rows(); ++i) {
+            for(size_t j=0; j < fine.cols(); ++j) {
+                if(fine(i, j)) {
+                    coarse.set(i / 2, j / 2);
+                }
+            }
+        }
+        Map coarse_map(rows, std::vector<double>(cols, 0));
+        for(size_t i=0; i < rows; ++i) {
+            for(size_t j=0; j < cols; ++j) {
+                if(coarse(i, j)) {
+                    coarse_map[i][j] = 1;
+                }
+            }
+        }
+        _levels.push_back(Level{coarse_map, scaled(p, rows, cols), coarse});
+    }
+}
+
+size_t Pyramid::levels() const
+{
+    return _levels.size();
+}
+
+const Pyramid::Level& Pyramid::level(size_t k) const
+{
+    assert(k < _levels.size());
+    return _levels[k];
+}
+
+const Map& Pyramid::map(size_t k) const
+{
+    return level(k).map;
+}
+
+const proj::Projection<double,size_t>& Pyramid::projection(size_t k) const
+{
+    return level(k).proj;
+}
+
+const domain::Bits& Pyramid::walls(size_t k) const
+{
+    return level(k).walls;
+}
+
+bool Pyramid::walled(size_t at, size_t i, size_t j, size_t level, const geom::Box& box) const
+{
+    if(not _levels[at].walls(i, j)) {
+        return false;
+    }
+    // Cells of the level covered by cell (i,j).
+    const size_t shift = at - level;
+    const domain::Bits& cells = _levels[level].walls;
+    const geom::Box block{
+        i << shift, j << shift,
+        std::min(((i+1) << shift) - 1, cells.rows()-1),
+        std::min(((j+1) << shift) - 1, cells.cols()-1)};
+    if(shift == 0 or (box.row_min <= block.row_min and block.row_max <= box.row_max
+                  and box.col_min <= block.col_min and block.col_max <= box.col_max)) {
+        return true;
+    }
+    // Partly covered: look at the finer cells within the box.
+    const size_t half = shift - 1;
+    const domain::Bits& finer = _levels[at-1].walls;
+    for(size_t fi = 2*i; fi <= 2*i+1 and fi < finer.rows(); ++fi) {
+        for(size_t fj = 2*j; fj <= 2*j+1 and fj < finer.cols(); ++fj) {
+            const bool crosses = (fi << half) <= box.row_max and box.row_min <= (((fi+1) << half) - 1)
+                             and (fj << half) <= box.col_max and box.col_min <= (((fj+1) << half) - 1);
+            if(crosses and walled(at-1, fi, fj, level, box)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool Pyramid::walled(size_t level, const geom::Box& box) const
+{
+    assert(level < _levels.size());
+    assert(box.row_max < _levels[level].walls.rows() and box.col_max < _levels[level].walls.cols());
+    // From the coarsest level down, only into the walled cells partly covered by the box.
+    const size_t top = _levels.size() - 1;
+    const size_t shift = top - level;
+    for(size_t i = box.row_min >> shift; i <= box.row_max >> shift; ++i) {
+        for(size_t j = box.col_min >> shift; j <= box.col_max >> shift; ++j) {
+            if(walled(top, i, j, level, box)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+unsigned int Pyramid::visibility(domain::Bits& visibles, size_t level, const int row, const int col,
+        const geom::Box& window, geom::Visibility algorithm) const
+{
+    const domain::Bits& walls = this->walls(level);
+    assert(visibles.rows() == window.rows() and visibles.cols() == window.cols());
+    assert(window.contains(row, col));
+
+    // Rays are cast towards the border of the map, which only reaches every pixel of square maps:
+    // elsewhere a wall-free pixel may not be seen.
+    if(walls.rows() != walls.cols()) {
+        return geom::visibility_map_2D(visibles, walls, row, col, window, algorithm);
+    }
+    if(walls(row, col)) {
+        return 0;
+    }
+
+    // Rays are monotonic, so that pixels of a quadrant are only hidden by walls of that quadrant.
+    const size_t r = row;
+    const size_t c = col;
+    const std::array<geom::Box,4> quadrants = {
+        geom::Box{window.row_min, window.col_min, r, c},
+        geom::Box{window.row_min, c, r, window.col_max},
+        geom::Box{r, window.col_min, window.row_max, c},
+        geom::Box{r, c, window.row_max, window.col_max}};
+
+    // Walled quadrants are traced at once, within their bounding box, which contains the sensor.
+    geom::Box traced{r, c, r, c};
+    std::array<bool,4> walled;
+    for(size_t q=0; q < quadrants.size(); ++q) {
+        walled[q] = this->walled(level, quadrants[q]);
+        if(walled[q]) {
+            traced.row_min = std::min(traced.row_min, quadrants[q].row_min);
+            traced.col_min = std::min(traced.col_min, quadrants[q].col_min);
+            traced.row_max = std::max(traced.row_max, quadrants[q].row_max);
+            traced.col_max = std::max(traced.col_max, quadrants[q].col_max);
+        }
+    }
+    if(traced.row_min == window.row_min and traced.col_min == window.col_min
+       and traced.row_max == window.row_max and traced.col_max == window.col_max) {
+        return geom::visibility_map_2D(visibles, walls, row, col, window, algorithm);
+    }
+
+    // Wall-free quadrants are seen entirely, they share the row and column of the sensor where they agree.
+    for(size_t q=0; q < quadrants.size(); ++q) {
+        if(not walled[q]) {
+            const geom::Box& quadrant = quadrants[q];
+            visibles.merge(domain::Bits(quadrant.rows(), quadrant.cols(), true),
+                    quadrant.row_min - window.row_min, quadrant.col_min - window.col_min);
+        }
+    }
+    if(traced.rows() > 1 or traced.cols() > 1) {
+        domain::Bits seen(traced.rows(), traced.cols());
+        geom::visibility_map_2D(seen, walls, row, col, traced, algorithm);
+        visibles.merge(seen, traced.row_min - window.row_min, traced.col_min - window.col_min);
+    }
+    return visibles.count();
+}
+
+} // inst
+} // ealain
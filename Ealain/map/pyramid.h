@@ -0,0 +1,82 @@
+#ifndef __EALAIN_PYRAMID_H__
+#define __EALAIN_PYRAMID_H__
+
+#include <vector>
+
+#include "bits.h"
+#include "geom.h"
+#include "instance.h"
+#include "projection.h"
+
+namespace ealain {
+
+    namespace inst {
+
+        /** Same instance discretized at several resolutions, for multi-fidelity optimisation.
+         *
+         * Level 0 is the given map, each next level halves the rows and columns of the previous one
+         * (rounding up), a cell being a wall if any of the cells it covers is one,
+         * so that walls never vanish at coarse levels.
+         * All levels map the same real-world ranges, with linear projections,
+         * so that the same camera coordinates can be evaluated at any level.
+         *
+         * Coarser levels also serve as an occupancy hierarchy of the finer ones,
+         * to skip tracing the wall-free parts of visibility maps (see visibility).
+         */
+        class Pyramid
+        {
+            public:
+                struct Level
+                {
+                    Map map;
+                    proj::Projection<double,size_t> proj;
+                    domain::Bits walls;
+                };
+
+            protected:
+                std::vector<Level> _levels;
+
+                // True if cell (i,j) of level `at` is a wall covering part of the box, in indices of level `level`.
+                bool walled(size_t at, size_t i, size_t j, size_t level, const geom::Box& box) const;
+
+            public:
+                /** Constructor
+                 *
+                 * p projection of the given map, which real-world ranges are kept at all levels.
+                 * levels maximum number of levels, including the given map,
+                 * less are built if a 1×1 level is reached first.
+                 */
+                Pyramid(const Map& map, const proj::Projection<double,size_t>& p, size_t levels);
+
+                // Number of levels.
+                size_t levels() const;
+
+                const Level& level(size_t k) const;
+
+                const Map& map(size_t k) const;
+
+                const proj::Projection<double,size_t>& projection(size_t k) const;
+
+                const domain::Bits& walls(size_t k) const;
+
+                // True if any cell of the box, in indices of the given level, is a wall.
+                bool walled(size_t level, const geom::Box& box) const;
+
+                /** Visibility map of the given level from cell (row,col), only covering the given window.
+                 *
+                 * Same as geom::visibility_map_2D on the walls of the level, visibles being empty beforehand.
+                 * As a pixel is only hidden by walls between it and the sensor,
+                 * the window is split in four quadrants around the sensor:
+                 * wall-free ones, found on coarser levels, are seen entirely without tracing,
+                 * and only the bounding box of the others is traced.
+                 * Returns the number of visible pixels.
+                 */
+                unsigned int visibility(domain::Bits& visibles, size_t level, const int row, const int col,
+                        const geom::Box& window, geom::Visibility algorithm = geom::Visibility::sweep) const;
+        };
+
+    } // inst
+
+} // ealain
+
+#endif // __EALAIN_PYRAMID_H__
@@ -93,7 +93,18 @@ namespace poly {
             const std::vector<std::vector<size_t>>& polygon)
     {
         std::vector<Pix> pixels;
+        rasterize(polygon, [&](size_t row, size_t first, size_t last) {
+            for(size_t pcol = first; pcol < last; pcol++) {
+                pixels.push_back( raster::pixel(row,pcol,1) );
+            }
+        });
+        return pixels;
+    }
 
+    void rasterize(
+            const std::vector<std::vector<size_t>>& polygon,
+            const std::function<void(size_t,size_t,size_t)>& span)
+    {
         const size_t drow = 0;
         const size_t dcol = 1;
 
@@ -143,15 +154,11 @@ namespace poly {
                 if(nodes[i+1] >  min_col) {
                     if(nodes[i  ] < min_col) { nodes[i  ] = min_col; }
                     if(nodes[i+1] > max_col) { nodes[i+1] = max_col; }
-                    for(size_t pcol = nodes[i]; pcol < nodes[i+1]; pcol++) {
-                        pixels.push_back( raster::pixel(current_row,pcol,1) );
-                    } // for pcol
+                    span(current_row, nodes[i], nodes[i+1]);
                 }
             } // for i
 
         } // for current_row
-
-        return pixels;
     }
 
 } // poly
@@ -4,6 +4,7 @@
 #include <cmath>
 #include <limits>
 #include <algorithm>
+#include <functional>
 
 #include "instance.h"
 
@@ -83,6 +84,14 @@ namespace ealain {
             std::vector<Pix> rasterize(
                     const std::vector<std::vector<size_t>>& polygon);
 
+            /** Same pixels as rasterize, given as spans of columns [first,last) on each row.
+             *
+             * Calls span(row, first, last), so that large polygons can be filled without listing their pixels.
+             */
+            void rasterize(
+                    const std::vector<std::vector<size_t>>& polygon,
+                    const std::function<void(size_t,size_t,size_t)>& span);
+
         } // poly
     } // raster
 } // ealain
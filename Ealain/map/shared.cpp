@@ -0,0 +1,232 @@
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EALAIN_INSTANCE_MMAP
+#endif
+
+#include "../utils.h"
+#include "geometry.h"
+#include "shared.h"
+
+namespace ealain {
+namespace inst {
+
+namespace {
+
+const char magic[8] = {'E','A','L','I','N','S','0','1'};
+
+const uint64_t version = 1;
+
+// Header: magic, then version, rows, cols and words per row as uint64, then the x and y ranges as doubles.
+struct Header
+{
+    char magic[8];
+    uint64_t version;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t words;
+    double min_x;
+    double max_x;
+    double min_y;
+    double max_y;
+};
+
+static_assert(sizeof(Header) == 9 * sizeof(uint64_t), "Unexpected padding of the instance header");
+
+domain::Bits rasterized(const Geometry& geometry, const proj::Projection<double,size_t>& p)
+{
+    domain::Bits walls(p[0].range_idx().max() + 1, p[1].range_idx().max() + 1);
+    geometry.rasterize(walls, p);
+    return walls;
+}
+
+// Words per row in the file, independent of the padding of domain::Bits.
+size_t file_words(size_t cols)
+{
+    return (cols + domain::Bits::word_bits - 1) / domain::Bits::word_bits;
+}
+
+// Error about the given instance file.
+std::runtime_error error(const std::string& filename, const std::string& what)
+{
+    return std::runtime_error(filename + ": " + what);
+}
+
+// Check the content of an instance file and copy its walls.
+Shared parse(const std::string& filename, const char* file, size_t bytes, size_t cache_budget, geom::Visibility engine)
+{
+    Header header;
+    if(bytes < sizeof(Header) or std::memcmp(file, magic, sizeof(magic)) != 0) {
+        throw error(filename, "not an instance file");
+    }
+    std::memcpy(&header, file, sizeof(header));
+    if(header.version != version) {
+        throw error(filename, "unsupported instance file version " + std::to_string(header.version));
+    }
+    if(header.rows == 0 or header.cols == 0 or header.words != file_words(header.cols)
+       or not (std::isfinite(header.min_x) and std::isfinite(header.max_x) and header.min_x < header.max_x)
+       or not (std::isfinite(header.min_y) and std::isfinite(header.max_y) and header.min_y < header.max_y)) {
+        throw error(filename, "corrupt instance header");
+    }
+    // Compared without overflowing.
+    const size_t row_bytes = header.words * sizeof(domain::Bits::Word);
+    if((bytes - sizeof(Header)) % row_bytes != 0 or (bytes - sizeof(Header)) / row_bytes != header.rows) {
+        throw error(filename, "instance file of unexpected size");
+    }
+
+    domain::Bits walls(header.rows, header.cols);
+    const char* rows = file + sizeof(Header);
+    for(size_t i=0; i < header.rows; ++i) {
+        domain::Bits::Word* row = walls.row(i);
+        std::memcpy(row, rows + i * row_bytes, row_bytes);
+        // Padding bits are expected to be zero.
+        if(header.cols % domain::Bits::word_bits != 0) {
+            row[header.words-1] &= (domain::Bits::Word(1) << (header.cols % domain::Bits::word_bits)) - 1;
+        }
+    }
+
+    return std::make_shared<const Instance>(std::move(walls),
+            rectangle_projection(header.rows, header.cols, header.min_x, header.max_x, header.min_y, header.max_y),
+            cache_budget, engine);
+}
+
+} // anonymous
+
+Instance::Instance(Map&& map, const proj::Projection<double,size_t>& p, size_t cache_budget, geom::Visibility engine) :
+    _map(std::move(map)),
+    _proj(p),
+    _walls(geom::walls(_map)),
+    _cache(cache_budget > 0 ? std::make_unique<geom::VisibilityCache>(_walls, cache_budget, engine) : nullptr)
+{
+    assert(_proj.size() == 2);
+    assert(_proj[0].range_idx().max() + 1 == _map.size());
+    assert(_proj[1].range_idx().max() + 1 == _map[0].size());
+    // The dense map is already there.
+    std::call_once(_dense, [](){});
+}
+
+Instance::Instance(domain::Bits&& walls, const proj::Projection<double,size_t>& p, size_t cache_budget, geom::Visibility engine) :
+    _proj(p),
+    _walls(std::move(walls)),
+    _cache(cache_budget > 0 ? std::make_unique<geom::VisibilityCache>(_walls, cache_budget, engine) : nullptr)
+{
+    assert(_proj.size() == 2);
+    assert(_proj[0].range_idx().max() + 1 == _walls.rows());
+    assert(_proj[1].range_idx().max() + 1 == _walls.cols());
+}
+
+Instance::Instance(const Geometry& geometry, const proj::Projection<double,size_t>& p, size_t cache_budget, geom::Visibility engine) :
+    _proj(p),
+    _walls(rasterized(geometry, p)),
+    _geometry(std::make_shared<const Geometry>(geometry)),
+    _cache(cache_budget == 0 ? nullptr
+            : engine == geom::Visibility::analytic
+            ? std::make_unique<geom::VisibilityCache>(*_geometry, _proj, _walls, cache_budget)
+            : std::make_unique<geom::VisibilityCache>(_walls, cache_budget, engine))
+{
+    assert(_proj.size() == 2);
+}
+
+const Map& Instance::map() const
+{
+    std::call_once(_dense, [this]() {
+        _map.assign(_walls.rows(), std::vector<double>(_walls.cols(), 0));
+        for(size_t i=0; i < _walls.rows(); ++i) {
+            _walls.expand(i, _map[i].data());
+        }
+    });
+    return _map;
+}
+
+Shared share(std::pair<Map,proj::Projection<double,size_t>>&& instance, size_t cache_budget, geom::Visibility engine)
+{
+    return std::make_shared<const Instance>(std::move(instance.first), instance.second, cache_budget, engine);
+}
+
+void save(const std::string& filename, const Instance& instance)
+{
+    const auto& p = instance.projection();
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.rows = instance.rows();
+    header.cols = instance.cols();
+    header.words = file_words(instance.cols());
+    header.min_x = p[0].range_irl().min();
+    header.max_x = p[0].range_irl().max();
+    header.min_y = p[1].range_irl().min();
+    header.max_y = p[1].range_irl().max();
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if(not out.is_open()) {
+        throw error(filename, std::string("cannot write the instance: ") + std::strerror(errno));
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for(size_t i=0; i < instance.rows(); ++i) {
+        out.write(reinterpret_cast<const char*>(instance.walls().row(i)), header.words * sizeof(domain::Bits::Word));
+    }
+    out.flush();
+    if(not out.good()) {
+        throw error(filename, "cannot write the instance");
+    }
+}
+
+Shared load(const std::string& filename, size_t cache_budget, geom::Visibility engine)
+{
+#ifdef EALAIN_INSTANCE_MMAP
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw error(filename, std::string("cannot open the instance: ") + std::strerror(errno));
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        const int code = errno;
+        close(fd);
+        throw error(filename, std::string("cannot read the instance: ") + std::strerror(code));
+    }
+    const size_t bytes = st.st_size;
+    if(bytes < sizeof(Header)) {
+        close(fd);
+        throw error(filename, "not an instance file");
+    }
+    void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+        throw error(filename, std::string("cannot map the instance: ") + std::strerror(errno));
+    }
+    Shared instance;
+    try {
+        instance = parse(filename, static_cast<const char*>(mapped), bytes, cache_budget, engine);
+    } catch(...) {
+        munmap(mapped, bytes);
+        throw;
+    }
+    munmap(mapped, bytes);
+    return instance;
+#else
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    if(not in.is_open()) {
+        throw error(filename, "cannot open the instance");
+    }
+    const size_t bytes = in.tellg();
+    std::vector<char> buffer(bytes);
+    in.seekg(0);
+    if(not in.read(buffer.data(), bytes)) {
+        throw error(filename, "cannot read the instance");
+    }
+    return parse(filename, buffer.data(), bytes, cache_budget, engine);
+#endif
+}
+
+} // inst
+} // ealain
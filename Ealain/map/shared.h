@@ -0,0 +1,116 @@
+#ifndef __EALAIN_SHARED_H__
+#define __EALAIN_SHARED_H__
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "bits.h"
+#include "cache.h"
+#include "instance.h"
+#include "projection.h"
+
+namespace ealain {
+
+    namespace inst {
+
+        class Geometry;
+
+        /** Immutable instance: the map, its projection and what is derived from them.
+         *
+         * Built once, then only handed out through a Shared handle,
+         * so that a map exists once per process however many cameras and evaluators use it,
+         * which keep it alive for as long as they hold the handle.
+         * Sensors and evaluators built on it only read the bit-packed walls,
+         * the dense map being built on first call to map() when the instance is made of walls only.
+         * All the methods are thread-safe.
+         */
+        class Instance
+        {
+            protected:
+                // Dense map, built once on first use if the instance was made from walls.
+                mutable Map _map;
+                mutable std::once_flag _dense;
+                const proj::Projection<double,size_t> _proj;
+                // Bit-packed occupancy of the map.
+                const domain::Bits _walls;
+                // Walls as vector geometry, if built from it.
+                const std::shared_ptr<const Geometry> _geometry;
+                // Visibility maps shared by all the sensors of the instance, if any.
+                const std::unique_ptr<geom::VisibilityCache> _cache;
+
+            public:
+                /** Constructor, prefer share().
+                 *
+                 * cache_budget bytes of visibility maps shared by the sensors, 0 meaning no cache.
+                 */
+                Instance(Map&& map, const proj::Projection<double,size_t>& p, size_t cache_budget = 0,
+                        geom::Visibility engine = geom::Visibility::sweep);
+
+                // Instance made of bit-packed walls only, as loaded from a binary instance file.
+                Instance(domain::Bits&& walls, const proj::Projection<double,size_t>& p, size_t cache_budget = 0,
+                        geom::Visibility engine = geom::Visibility::sweep);
+
+                /** Instance of the given wall geometry, rasterized straight into bit-packed walls, prefer share().
+                 *
+                 * The geometry is kept for the analytic engine,
+                 * which then computes the visibility maps of the cache, if any.
+                 */
+                Instance(const Geometry& geometry, const proj::Projection<double,size_t>& p, size_t cache_budget = 0,
+                        geom::Visibility engine = geom::Visibility::sweep);
+
+                Instance(const Instance&) = delete;
+                Instance& operator=(const Instance&) = delete;
+
+                // Dense map, built on first call if the instance was made from walls.
+                const Map& map() const;
+                const proj::Projection<double,size_t>& projection() const {return _proj;}
+                const domain::Bits& walls() const {return _walls;}
+
+                // Walls as vector geometry, nullptr if not built from it.
+                const Geometry* geometry() const {return _geometry.get();}
+
+                // Shared visibility maps, nullptr if built without cache.
+                geom::VisibilityCache* cache() const {return _cache.get();}
+
+                size_t rows() const {return _walls.rows();}
+                size_t cols() const {return _walls.cols();}
+        };
+
+        // Reference-counted handle on an immutable instance.
+        using Shared = std::shared_ptr<const Instance>;
+
+        /** Share an instance as returned by rectangle or rectangle_walls, without copying its map.
+         *
+         * cache_budget bytes of visibility maps shared by the sensors, 0 meaning no cache.
+         */
+        Shared share(std::pair<Map,proj::Projection<double,size_t>>&& instance, size_t cache_budget = 0,
+                geom::Visibility engine = geom::Visibility::sweep);
+
+        /** Write the walls and real-world ranges of an instance in a binary instance file.
+         *
+         * The file holds a header (magic bytes, version, rows, columns, words per row,
+         * then the x and y ranges as doubles),
+         * followed by the walls bit-packed row by row as in domain::Bits,
+         * each row padded to a whole number of 64 bits words.
+         * The projection of the instance should be linear, as built by rectangle.
+         * Throws std::runtime_error if the file cannot be written.
+         */
+        void save(const std::string& filename, const Instance& instance);
+
+        /** Load a binary instance file written by save.
+         *
+         * The file is memory-mapped and its walls copied as is, without parsing,
+         * and the dense map is only built if asked for (see Instance::map).
+         * cache_budget bytes of visibility maps shared by the sensors, 0 meaning no cache.
+         * Throws std::runtime_error if the file cannot be read, or is not a well-formed instance file.
+         */
+        Shared load(const std::string& filename, size_t cache_budget = 0,
+                geom::Visibility engine = geom::Visibility::sweep);
+
+    } // inst
+
+} // ealain
+
+#endif // __EALAIN_SHARED_H__
@@ -0,0 +1,184 @@
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+
+#include "utils.h"
+#include "trace.h"
+
+namespace ealain {
+namespace trace {
+
+namespace {
+
+    // Counters of a thread, only written by it, but read by the reporting thread.
+    struct Local
+    {
+        struct Atomic
+        {
+            std::atomic<std::uint64_t> calls{0};
+            std::atomic<std::uint64_t> cells{0};
+            std::atomic<std::uint64_t> ns{0};
+        };
+        std::array<Atomic,phases> counters;
+
+        Local();
+        ~Local();
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<Local*> live;
+        // Totals of the threads which have exited.
+        Counters retired;
+    };
+
+    // Never destroyed, so that threads exiting late and the report at exit can still use it.
+    Registry& registry()
+    {
+        static Registry* r = new Registry;
+        return *r;
+    }
+
+    Local::Local()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(this);
+    }
+
+    Local::~Local()
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for(std::size_t p = 0; p < phases; ++p) {
+            r.retired[p].calls += counters[p].calls.load(std::memory_order_relaxed);
+            r.retired[p].cells += counters[p].cells.load(std::memory_order_relaxed);
+            r.retired[p].ns += counters[p].ns.load(std::memory_order_relaxed);
+        }
+        r.live.erase(std::find(ALL(r.live), this));
+    }
+
+    Local& local()
+    {
+        thread_local Local counters;
+        return counters;
+    }
+
+    // A single writer per counter, so that no atomic read-modify-write is needed.
+    void increase(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+} // anonymous
+
+const char* name(Phase phase)
+{
+    switch(phase) {
+        case Phase::update:     return "update";
+        case Phase::visibility: return "visibility";
+        case Phase::projection: return "projection";
+        case Phase::sense:      return "sense";
+        case Phase::rows:       return "rows";
+        case Phase::binary:     return "binary";
+        case Phase::coverage:   return "coverage";
+        case Phase::cache_hit:  return "cache_hit";
+        case Phase::cache_miss: return "cache_miss";
+    }
+    assert(false);
+    return "";
+}
+
+void add(Phase phase, std::uint64_t cells, std::uint64_t ns)
+{
+    Local::Atomic& counter = local().counters[static_cast<std::size_t>(phase)];
+    increase(counter.calls, 1);
+    increase(counter.cells, cells);
+    increase(counter.ns, ns);
+}
+
+Counters totals()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Counters sum = r.retired;
+    for(const Local* l : r.live) {
+        for(std::size_t p = 0; p < phases; ++p) {
+            sum[p].calls += l->counters[p].calls.load(std::memory_order_relaxed);
+            sum[p].cells += l->counters[p].cells.load(std::memory_order_relaxed);
+            sum[p].ns += l->counters[p].ns.load(std::memory_order_relaxed);
+        }
+    }
+    return sum;
+}
+
+void reset()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = Counters();
+    for(Local* l : r.live) {
+        for(auto& counter : l->counters) {
+            counter.calls.store(0, std::memory_order_relaxed);
+            counter.cells.store(0, std::memory_order_relaxed);
+            counter.ns.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void json(std::ostream& out)
+{
+    const Counters sum = totals();
+    out << "{\n  \"enabled\": " << (enabled() ? "true" : "false") << ",\n  \"phases\": {";
+    for(std::size_t p = 0; p < phases; ++p) {
+        out << (p > 0 ? "," : "") << "\n    \"" << name(static_cast<Phase>(p)) << "\": {"
+            << "\"calls\": " << sum[p].calls
+            << ", \"cells\": " << sum[p].cells
+            << ", \"ns\": " << sum[p].ns << "}";
+    }
+    out << "\n  }\n}\n";
+}
+
+void csv(std::ostream& out)
+{
+    const Counters sum = totals();
+    out << "phase,calls,cells,ns\n";
+    for(std::size_t p = 0; p < phases; ++p) {
+        out << name(static_cast<Phase>(p)) << "," << sum[p].calls << "," << sum[p].cells << "," << sum[p].ns << "\n";
+    }
+}
+
+void dump(const std::string& filename)
+{
+    std::ofstream out(filename);
+    const std::string ext = ".csv";
+    if(filename.size() >= ext.size() and filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0) {
+        csv(out);
+    } else {
+        json(out);
+    }
+}
+
+#ifdef WITH_INSTRUMENTATION
+namespace {
+
+    // Report at exit in the file named by the EALAIN_TRACE environment variable, if any.
+    struct AtExit
+    {
+        AtExit()
+        {
+            if(std::getenv("EALAIN_TRACE")) {
+                std::atexit([]() {dump(std::getenv("EALAIN_TRACE"));});
+            }
+        }
+    };
+    const AtExit at_exit;
+
+} // anonymous
+#endif
+
+} // trace
+} // ealain
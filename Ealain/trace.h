@@ -0,0 +1,134 @@
+#ifndef __EALAIN_TRACE_H__
+#define __EALAIN_TRACE_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/** Optional instrumentation of the hot paths.
+ *
+ * When compiled with WITH_INSTRUMENTATION (cmake -DUSE_INSTRUMENTATION=ON),
+ * each phase accumulates its number of calls, of cells processed and its wall-clock time,
+ * in counters local to each thread, which are summed up when a report is asked for.
+ * Without it, the EALAIN_TRACE* and EALAIN_COUNT macros expand to nothing,
+ * and reports are all zeros.
+ *
+ * Phases nest: e.g. the time of coverage includes the time of rows, which includes the one of update.
+ *
+ * If the EALAIN_TRACE environment variable holds a file name, a report is written in it at exit,
+ * as CSV if the name ends with ".csv", as JSON otherwise.
+ */
+
+#ifdef WITH_INSTRUMENTATION
+    // Time the rest of the enclosing scope as the given phase, having processed the given number of cells.
+    #define EALAIN_TRACE(phase, cells) \
+        ealain::trace::Scope _ealain_trace_scope(ealain::trace::Phase::phase, cells)
+    // Set the number of cells of the phase timed by the enclosing EALAIN_TRACE, once it is known.
+    #define EALAIN_TRACE_CELLS(n) \
+        _ealain_trace_scope.cells(n)
+    // Count a call of the given phase, having processed the given number of cells, without timing it.
+    #define EALAIN_COUNT(phase, cells) \
+        ealain::trace::count(ealain::trace::Phase::phase, cells)
+#else
+    #define EALAIN_TRACE(phase, cells)
+    #define EALAIN_TRACE_CELLS(n)
+    #define EALAIN_COUNT(phase, cells)
+#endif
+
+namespace ealain {
+
+    namespace trace {
+
+        enum class Phase : std::size_t {
+            update,     // Situated::update: locating the sensor and getting its visibility map.
+            visibility, // Computing a visibility map (cache misses and uncached sensors).
+            projection, // Mapping axes indices to numerical coordinates.
+            sense,      // Cell-by-cell evaluation of a sensor or group.
+            rows,       // Row-by-row evaluation of a group (in place or streamed).
+            binary,     // Bit-packed evaluation of a group of binary sensors.
+            coverage,   // Coverage of a domain, including the evaluation of its group.
+            cache_hit,  // Visibility maps found in a VisibilityCache.
+            cache_miss  // Visibility maps recomputed by a VisibilityCache.
+        };
+
+        // Number of phases.
+        const std::size_t phases = static_cast<std::size_t>(Phase::cache_miss) + 1;
+
+        // Name of a phase, as used in reports.
+        const char* name(Phase phase);
+
+        // Totals of a phase.
+        struct Counter
+        {
+            std::uint64_t calls = 0;
+            std::uint64_t cells = 0;
+            std::uint64_t ns = 0;
+        };
+
+        using Counters = std::array<Counter,phases>;
+
+        // True if compiled with the instrumentation.
+        constexpr bool enabled()
+        {
+#ifdef WITH_INSTRUMENTATION
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        // Add to the counters of the calling thread.
+        void add(Phase phase, std::uint64_t cells, std::uint64_t ns);
+
+        inline void count(Phase phase, std::uint64_t cells)
+        {
+            add(phase, cells, 0);
+        }
+
+        // Times its own lifetime as one call of a phase.
+        class Scope
+        {
+            protected:
+                using clock = std::chrono::steady_clock;
+                const Phase _phase;
+                std::uint64_t _cells;
+                const clock::time_point _start;
+
+            public:
+                Scope(Phase phase, std::uint64_t cells) :
+                    _phase(phase), _cells(cells), _start(clock::now())
+                {}
+
+                void cells(std::uint64_t n) {_cells = n;}
+
+                ~Scope()
+                {
+                    add(_phase, _cells, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start).count());
+                }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+        };
+
+        // Sum of the counters of all the threads, including the ones which have exited.
+        Counters totals();
+
+        // Zero the counters of all the threads.
+        void reset();
+
+        // Write the totals as a JSON object, or as CSV with a header line.
+        void json(std::ostream& out);
+        void csv(std::ostream& out);
+
+        // Write the totals to a file, as CSV if its name ends with ".csv", as JSON otherwise.
+        void dump(const std::string& filename);
+
+    } // trace
+
+} // ealain
+
+#endif // __EALAIN_TRACE_H__
@@ -39,6 +39,14 @@ namespace ealain {
         unsigned int items(const T& array);
     } // size
 
+    /** Split [0,n) in contiguous tiles, and call f(first, last) on each of them from its own thread.
+     *
+     * threads number of tiles, 0 meaning the hardware concurrency, 1 running f in the calling thread.
+     * Returns once all the tiles are done.
+     */
+    template<class F>
+    void parallel_tiles(std::size_t n, std::size_t threads, F f);
+
     // Add space separators to a number representation.
     std::string format(unsigned int number);
 
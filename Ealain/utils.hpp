@@ -1,4 +1,6 @@
 #include <cmath>
+#include <algorithm>
+#include <thread>
 
 namespace ealain {
 
@@ -46,6 +48,29 @@ namespace size {
     }
 } // size
 
+template<class F>
+void parallel_tiles(std::size_t n, std::size_t threads, F f)
+{
+    if(threads == 0) {
+        threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, n);
+    if(threads <= 1) {
+        f(0, n);
+        return;
+    }
+    std::vector<std::thread> workers;
+    workers.reserve(threads-1);
+    for(std::size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(f, t * n / threads, (t+1) * n / threads);
+    }
+    // The calling thread takes the first tile.
+    f(0, n / threads);
+    for(auto& worker : workers) {
+        worker.join();
+    }
+}
+
 template <typename From, typename To>
 To static_caster<From,To>::operator()(From x) {return static_cast<To>(x);}
 
@@ -0,0 +1,411 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include <cstring>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/geom.h>
+#include <Ealain/map/raster.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/map/projection.h>
+#include <Ealain/detection/kernel.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+/**
+ * Microbenchmarks of visibility, rasterization, detection, aggregation and coverage.
+ *
+ * Each case runs on instances generated from a fixed seed, across map sizes, camera counts,
+ * ranges and wall densities, so that runs are comparable between releases.
+ * A case is run once to warm up (which also computes the visibility maps of the cameras),
+ * then repeatedly for at least --min-time seconds (and 3 runs).
+ *
+ * Results are written as JSON: the timings of each case (in nanoseconds per run),
+ * its parameters, and a checksum of its output, which should not change between releases.
+ * Cases which output changes between runs are reported, and the exit status is then 1.
+ */
+
+// How to launch:
+// ./ealain_bench [--quick] [--filter substring] [--output results.json] [--min-time seconds] [--seed n]
+
+using namespace ealain;
+
+using Params = std::vector<std::pair<std::string,double>>;
+
+struct Result
+{
+    std::string name;
+    Params params;
+    size_t runs;
+    double min_ns;
+    double median_ns;
+    double mean_ns;
+    double checksum;
+};
+
+struct Options
+{
+    bool quick = false;
+    std::string filter;
+    std::string output;
+    double min_time = 0.2;
+    unsigned long seed = 0;
+};
+
+class Suite
+{
+    protected:
+        const Options& _options;
+        std::vector<Result> _results;
+        // Number of cases which output changed between runs.
+        size_t _unstable;
+
+    public:
+        Suite(const Options& options) : _options(options), _unstable(0) {}
+
+        const std::vector<Result>& results() const {return _results;}
+
+        // True if every case gave the same output at each run.
+        bool stable() const {return _unstable == 0;}
+
+        // Time f(), which returns a checksum of its output, if name matches the filter.
+        template<class F>
+        void run(const std::string& name, const Params& params, F f)
+        {
+            if(name.find(_options.filter) == std::string::npos) {
+                return;
+            }
+            using clock = std::chrono::steady_clock;
+
+            const double checksum = f();
+            std::vector<double> times;
+            double total = 0;
+            bool unchanged = true;
+            while((total < _options.min_time or times.size() < 3) and times.size() < 10000) {
+                const auto start = clock::now();
+                const double c = f();
+                const auto end = clock::now();
+                // Unchanged output at each run.
+                if(c != checksum and unchanged) {
+                    std::cerr << name << ": checksum " << c << " at run " << times.size()+1
+                              << " instead of " << checksum << std::endl;
+                    unchanged = false;
+                    _unstable++;
+                }
+                const double seconds = std::chrono::duration<double>(end - start).count();
+                times.push_back(seconds * 1e9);
+                total += seconds;
+            }
+            std::sort(ALL(times));
+
+            Result result{name, params, times.size(),
+                times.front(), times[times.size() / 2],
+                std::accumulate(ALL(times), 0.0) / times.size(),
+                checksum};
+            std::clog << name;
+            for(const auto& param : params) {
+                std::clog << " " << param.first << "=" << param.second;
+            }
+            std::clog << ": " << result.median_ns / 1e6 << " ms" << std::endl;
+            _results.push_back(result);
+        }
+};
+
+// A square map with random walls, and its projection on as many real-world units.
+struct Instance
+{
+    inst::Map map;
+    proj::Projection<double,size_t> proj;
+
+    Instance(size_t n, double density, std::mt19937& rng) :
+        Instance(inst::rectangle(n, n, n, n), density, rng)
+    {}
+
+    Instance(const std::pair<inst::Map,proj::Projection<double,size_t>>& square, double density, std::mt19937& rng) :
+        map(square.first),
+        proj(square.second)
+    {
+        std::bernoulli_distribution wall(density);
+        for(auto& row : map) {
+            for(auto& cell : row) {
+                cell = wall(rng) ? 1 : 0;
+            }
+        }
+    }
+
+    // Random cells which are not walls.
+    std::vector<std::pair<size_t,size_t>> free_cells(size_t count, std::mt19937& rng) const
+    {
+        std::uniform_int_distribution<size_t> index(0, map.size()-1);
+        std::vector<std::pair<size_t,size_t>> cells;
+        while(cells.size() < count) {
+            const size_t i = index(rng);
+            const size_t j = index(rng);
+            if(map[i][j] != 1) {
+                cells.push_back({i, j});
+            }
+        }
+        return cells;
+    }
+};
+
+// Sum of the cells of a domain.
+double sum(const domain::Plan& domain)
+{
+    return std::accumulate(ALL(domain.buffer()), 0.0);
+}
+
+void bench_visibility(Suite& suite, const Options& options, std::mt19937& rng)
+{
+    const std::vector<size_t> sizes = options.quick ? std::vector<size_t>{64} : std::vector<size_t>{100, 200, 400};
+    for(size_t n : sizes) {
+        for(double density : {0.0, 0.05, 0.2}) {
+            Instance instance(n, density, rng);
+            const auto sensors = instance.free_cells(8, rng);
+            domain::PlanT<char> visibles(n, n, 0);
+            const Params params = {{"size", double(n)}, {"walls", density}, {"sensors", double(sensors.size())}};
+
+            suite.run("visibility/ray_tracing", params, [&]() {
+                double seen = 0;
+                for(const auto& s : sensors) {
+                    visibles.buffer().fill(0);
+                    seen += geom::visibility_map_2D_ray_tracing(visibles, instance.map, s.first, s.second);
+                }
+                return seen;
+            });
+            suite.run("visibility/sweep", params, [&]() {
+                double seen = 0;
+                for(const auto& s : sensors) {
+                    visibles.buffer().fill(0);
+                    seen += geom::visibility_map_2D_sweep(visibles, instance.map, s.first, s.second);
+                }
+                return seen;
+            });
+        }
+    }
+}
+
+void bench_raster(Suite& suite, const Options& options, std::mt19937& rng)
+{
+    const std::vector<size_t> sizes = options.quick ? std::vector<size_t>{64} : std::vector<size_t>{100, 400, 1000};
+    for(size_t n : sizes) {
+        // Lines from the center to every border pixel.
+        suite.run("raster/bresenham", {{"size", double(n)}}, [n]() {
+            const float c = n / 2;
+            double pixels = 0;
+            for(size_t k = 0; k < n; ++k) {
+                pixels += raster::line::bresenham(c, c, 0, k).size();
+                pixels += raster::line::bresenham(c, c, n-1, k).size();
+                pixels += raster::line::bresenham(c, c, k, 0).size();
+                pixels += raster::line::bresenham(c, c, k, n-1).size();
+            }
+            return pixels;
+        });
+
+        std::uniform_int_distribution<size_t> coord(0, n-1);
+        std::uniform_int_distribution<size_t> vertices(3, 8);
+        std::vector<std::vector<std::vector<size_t>>> polygons(20);
+        for(auto& polygon : polygons) {
+            const size_t m = vertices(rng);
+            for(size_t v = 0; v < m; ++v) {
+                polygon.push_back({coord(rng), coord(rng)});
+            }
+        }
+        suite.run("raster/rasterize", {{"size", double(n)}, {"polygons", double(polygons.size())}}, [&polygons]() {
+            double pixels = 0;
+            for(const auto& polygon : polygons) {
+                pixels += raster::poly::rasterize(polygon).size();
+            }
+            return pixels;
+        });
+    }
+}
+
+void bench_detection(Suite& suite, const Options& options, std::mt19937& rng)
+{
+    const std::vector<size_t> sizes = options.quick ? std::vector<size_t>{64} : std::vector<size_t>{100, 400, 1000};
+    for(size_t n : sizes) {
+        Instance instance(n, 0.05, rng);
+        const auto cell = instance.free_cells(1, rng).front();
+        for(double range : {n / 10.0, n / 3.0}) {
+            const Params params = {{"size", double(n)}, {"range", range}};
+            domain::Plan domain(instance.proj, 0);
+
+            camera::Omnidir omnidir(instance.map, instance.proj, cell.first, cell.second, range);
+            suite.run("detection/omnidir", params, [&]() {
+                return sum(omnidir(domain));
+            });
+
+            camera::Omnibinary omnibinary(instance.map, instance.proj, cell.first, cell.second, range);
+            suite.run("detection/omnibinary", params, [&]() {
+                return sum(omnibinary(domain));
+            });
+        }
+    }
+}
+
+void bench_groups(Suite& suite, const Options& options, std::mt19937& rng)
+{
+    const std::vector<size_t> sizes = options.quick ? std::vector<size_t>{64} : std::vector<size_t>{200, 1000};
+    const std::vector<size_t> counts = options.quick ? std::vector<size_t>{4} : std::vector<size_t>{1, 10, 50};
+    for(size_t n : sizes) {
+        Instance instance(n, 0.05, rng);
+        for(size_t count : counts) {
+            const double range = n / 8.0;
+            std::vector<camera::Omnidir> cameras;
+            for(const auto& cell : instance.free_cells(count, rng)) {
+                cameras.emplace_back(instance.map, instance.proj, cell.first, cell.second, range);
+            }
+            const Params params = {{"size", double(n)}, {"cameras", double(count)}, {"range", range}};
+
+            group::proba::AtLeastOne at_least_one(instance.proj);
+            group::Additive additive(instance.proj);
+            group::Multiplicative multiplicative(instance.proj);
+            group::Min min(instance.proj);
+            group::Max max(instance.proj);
+            group::Binary binary(instance.proj, 0.5);
+            group::Aggregate aggregate(instance.proj, 0,
+                    [](const double& lhs, const double& rhs) {return std::max(lhs, rhs);});
+            const std::vector<std::pair<std::string,group::Group*>> all = {
+                {"at_least_one", &at_least_one}, {"additive", &additive}, {"multiplicative", &multiplicative},
+                {"min", &min}, {"max", &max}, {"binary", &binary}, {"aggregate", &aggregate}};
+
+            domain::Plan domain(instance.proj, 0);
+            for(const auto& named : all) {
+                for(auto& camera : cameras) {
+                    named.second->bind(camera);
+                }
+                suite.run("group/" + named.first, params, [&]() {
+                    named.second->evaluate(domain);
+                    return sum(domain);
+                });
+            }
+        }
+    }
+}
+
+template<class C>
+void bench_coverage(Suite& suite, const Options& options, std::mt19937& rng, const std::string& type)
+{
+    const std::vector<size_t> sizes = options.quick ? std::vector<size_t>{64} : std::vector<size_t>{200, 1000};
+    const std::vector<size_t> counts = options.quick ? std::vector<size_t>{4} : std::vector<size_t>{10, 50};
+    for(size_t n : sizes) {
+        for(double density : {0.0, 0.2}) {
+            Instance instance(n, density, rng);
+            for(size_t count : counts) {
+                const double range = n / 8.0;
+                std::vector<C> cameras;
+                for(const auto& cell : instance.free_cells(count, rng)) {
+                    cameras.emplace_back(instance.map, instance.proj, cell.first, cell.second, range);
+                }
+                group::proba::AtLeastOne group(instance.proj);
+                for(auto& camera : cameras) {
+                    group.bind(camera);
+                }
+                const Params params = {{"size", double(n)}, {"walls", density}, {"cameras", double(count)}, {"range", range}};
+
+                domain::Plan domain(instance.proj, 0);
+                cost::Coverage<domain::Plan> stored(domain, 0.5);
+                suite.run("coverage/" + type + "/store", params, [&]() {
+                    return stored(group);
+                });
+                cost::Coverage<domain::Plan> reduced(domain, 0.5, false);
+                suite.run("coverage/" + type + "/reduce", params, [&]() {
+                    return reduced(group);
+                });
+            }
+        }
+    }
+}
+
+std::string isa_name(kernel::ISA set)
+{
+    switch(set) {
+        case kernel::ISA::avx512: return "avx512";
+        case kernel::ISA::avx2: return "avx2";
+        case kernel::ISA::scalar:
+        default: return "scalar";
+    }
+}
+
+void json(std::ostream& out, const Options& options, const std::vector<Result>& results)
+{
+    out.precision(12);
+    out << "{\n";
+    out << "  \"version\": \"" << EALAIN_VERSION << "\",\n";
+    out << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    out << "  \"isa\": \"" << isa_name(kernel::isa()) << "\",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n";
+    out << "  \"benchmarks\": [";
+    for(size_t r = 0; r < results.size(); ++r) {
+        const Result& result = results[r];
+        out << (r > 0 ? "," : "") << "\n    {\"name\": \"" << result.name << "\", \"params\": {";
+        for(size_t p = 0; p < result.params.size(); ++p) {
+            out << (p > 0 ? ", " : "") << "\"" << result.params[p].first << "\": " << result.params[p].second;
+        }
+        out << "}, \"runs\": " << result.runs
+            << ", \"min_ns\": " << result.min_ns
+            << ", \"median_ns\": " << result.median_ns
+            << ", \"mean_ns\": " << result.mean_ns
+            << ", \"checksum\": " << result.checksum << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    for(int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        if(arg == "--quick") {
+            options.quick = true;
+        } else if(arg == "--filter" and a+1 < argc) {
+            options.filter = argv[++a];
+        } else if(arg == "--output" and a+1 < argc) {
+            options.output = argv[++a];
+        } else if(arg == "--min-time" and a+1 < argc) {
+            options.min_time = std::atof(argv[++a]);
+        } else if(arg == "--seed" and a+1 < argc) {
+            options.seed = std::strtoul(argv[++a], nullptr, 10);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--quick] [--filter substring] [--output results.json] [--min-time seconds] [--seed n]" << std::endl;
+            return 1;
+        }
+    }
+
+    Suite suite(options);
+    std::mt19937 rng(options.seed);
+    bench_visibility(suite, options, rng);
+    bench_raster(suite, options, rng);
+    bench_detection(suite, options, rng);
+    bench_groups(suite, options, rng);
+    bench_coverage<camera::Omnidir>(suite, options, rng, "omnidir");
+    bench_coverage<camera::Omnibinary>(suite, options, rng, "omnibinary");
+
+    if(options.output.empty()) {
+        json(std::cout, options, suite.results());
+    } else {
+        std::ofstream out(options.output);
+        json(out, options, suite.results());
+    }
+    if(not suite.stable()) {
+        std::cerr << "Some outputs changed between runs" << std::endl;
+        return 1;
+    }
+    return 0;
+}
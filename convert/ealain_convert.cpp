@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <Ealain/map/instance.h>
+#include <Ealain/map/shared.h>
+
+/**
+ * Convert a csv file of walls into a binary instance file.
+ *
+ * The csv holds one wall per line, as the row and column of its pixel, as read by rectangle_walls.
+ * The binary file holds the bit-packed walls and the real-world ranges of the instance,
+ * and is loaded by ealain::inst::load, or by example_server --instance, without any parsing.
+ */
+
+// How to launch:
+// ./ealain_convert walls.csv rows cols size_x size_y instance.bin
+
+int main(int argc, char* argv[])
+{
+    if(argc != 7) {
+        std::cerr << "Usage: " << argv[0] << " walls.csv rows cols size_x size_y instance.bin" << std::endl;
+        return 1;
+    }
+    const std::string walls = argv[1];
+    const size_t rows = atoi(argv[2]);
+    const size_t cols = atoi(argv[3]);
+    const double size_x = atof(argv[4]);
+    const double size_y = atof(argv[5]);
+    const std::string output = argv[6];
+
+    ealain::inst::Shared instance;
+    try {
+        instance = ealain::inst::share(ealain::inst::rectangle_walls(walls, rows, cols, size_x, size_y));
+        ealain::inst::save(output, *instance);
+    } catch(const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << rows << "x" << cols << " instance with " << instance->walls().count() << " walls written to " << output << std::endl;
+    return 0;
+}
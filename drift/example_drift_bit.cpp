@@ -14,6 +14,7 @@
 #include <Ealain/map/cuboid.h>
 #include <Ealain/map/geom.h>
 #include <Ealain/map/projection.h>
+#include <Ealain/map/shared.h>
 #include <Ealain/detection/group.h>
 #include <Ealain/detection/camera.h>
 
@@ -112,9 +113,9 @@ int main(int argc, char* argv[])
 
     // Set map
     int m = static_cast<int>(n);
-    std::pair<ealain::inst::Map,ealain::proj::Projection<double,size_t>> d = ealain::inst::rectangle(m,m,n,n);
-    ealain::inst::Map map = d.first;
-    ealain::proj::Projection<double,size_t> p_map = d.second;
+    const ealain::inst::Shared instance = ealain::inst::share(ealain::inst::rectangle(m,m,n,n));
+    const ealain::inst::Map& map = instance->map();
+    const ealain::proj::Projection<double,size_t>& p_map = instance->projection();
     ealain::camera::Omnidir::Domain domain(p_map);
 
 
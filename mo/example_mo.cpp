@@ -11,6 +11,7 @@
 #include <Ealain/map/cuboid.h>
 #include <Ealain/map/geom.h>
 #include <Ealain/map/projection.h>
+#include <Ealain/map/shared.h>
 #include <Ealain/detection/group.h>
 #include <Ealain/detection/camera.h>
 
@@ -33,9 +34,9 @@ int main(int argc, char* argv[])
     unsigned int n;// # of points in each dimension
     n = atoi(argv[1]);
     double m = static_cast<double>(n);
-    std::pair<ealain::inst::Map,ealain::proj::Projection<double,size_t>> d = ealain::inst::rectangle_walls("",n,n,m,m);
-    ealain::inst::Map map = d.first;
-    ealain::proj::Projection<double,size_t> p_map = d.second;
+    const ealain::inst::Shared instance = ealain::inst::share(ealain::inst::rectangle_walls("",n,n,m,m));
+    const ealain::inst::Map& map = instance->map();
+    const ealain::proj::Projection<double,size_t>& p_map = instance->projection();
     Domain domain(n,n,0);
 
     // Read coordinates and set cam
@@ -0,0 +1,284 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <csignal>
+#include <limits>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <Ealain/cost.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/map/shared.h>
+#include <Ealain/map/projection.h>
+#include <Ealain/detection/camera.h>
+
+/**
+ * Persistent single objective evaluator
+ *
+ * Same instance and fitness as example_so (or example_drift_bit with --bits),
+ * but the instance is built once and solutions are read one per line,
+ * from the standard input or from the clients of a Unix socket.
+ * Each line holds the solution values separated by spaces,
+ * the answer is a line holding its fitness, or "nan" if the line is malformed.
+ *
+ * Requests can be pipelined: all the lines already received are evaluated together, in parallel,
+ * and answered in order.
+ */
+
+// How to launch:
+// ./example_server instance_size [--bits] [--walls file.csv | --instance file.bin] [--socket path] [--threads n]
+// Then send lines: x0 y0 x1 y1 ... (numerical encoding) or b0 b1 ... (discrete encoding).
+
+// Minimal stream buffer over a file descriptor.
+class FdBuffer : public std::streambuf
+{
+    protected:
+        int _fd;
+        char _in[1 << 16];
+        char _out[1 << 16];
+
+    public:
+        FdBuffer(int fd) : _fd(fd)
+        {
+            setg(_in, _in, _in);
+            setp(_out, _out + sizeof(_out));
+        }
+
+        ~FdBuffer() {sync();}
+
+    protected:
+        int underflow()
+        {
+            ssize_t n;
+            do {
+                n = ::read(_fd, _in, sizeof(_in));
+            } while(n < 0 and errno == EINTR);
+            if(n <= 0) {
+                return traits_type::eof();
+            }
+            setg(_in, _in, _in + n);
+            return traits_type::to_int_type(*gptr());
+        }
+
+        int overflow(int c)
+        {
+            if(sync() != 0) {
+                return traits_type::eof();
+            }
+            if(c != traits_type::eof()) {
+                *pptr() = c;
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync()
+        {
+            for(char* p = pbase(); p < pptr();) {
+                const ssize_t n = ::write(_fd, p, pptr() - p);
+                if(n < 0 and errno == EINTR) {
+                    continue;
+                }
+                if(n <= 0) {
+                    return -1;
+                }
+                p += n;
+            }
+            setp(_out, _out + sizeof(_out));
+            return 0;
+        }
+};
+
+struct Instance
+{
+    size_t n;
+    bool bits;
+    size_t threads;
+    // Map, projection and visibility cache, shared by all the evaluations.
+    ealain::inst::Shared shared;
+};
+
+/** Read one solution, in the same encoding as the examples, as cameras coordinates.
+ *
+ * Return false if the line is malformed: not only numbers, not the right number of them,
+ * coordinates out of [0,1] or bits other than 0 and 1.
+ */
+bool parse(const std::string& line, const Instance& instance, std::vector<double>& xy)
+{
+    std::istringstream values(line);
+    std::vector<double> solution;
+    double v;
+    while(values >> v) {
+        solution.push_back(v);
+    }
+    if(not values.eof()) {
+        return false;
+    }
+
+    xy.clear();
+    if(instance.bits) {
+        // Cameras on each cell set to 1, in row-major order.
+        if(solution.size() != instance.n * instance.n) {
+            return false;
+        }
+        for(size_t cell = 0; cell < solution.size(); ++cell) {
+            if(solution[cell] != 0 and solution[cell] != 1) {
+                return false;
+            }
+            if(solution[cell] == 1) {
+                xy.push_back(cell / instance.n);
+                xy.push_back(cell % instance.n);
+            }
+        }
+    } else {
+        // Normalized coordinates.
+        if(solution.size() % 2 != 0) {
+            return false;
+        }
+        for(const double x : solution) {
+            // Also rejects NaN.
+            if(not (0 <= x and x <= 1)) {
+                return false;
+            }
+            xy.push_back((instance.n-1) * x);
+        }
+    }
+    return true;
+}
+
+// Answer all the solutions read from in, until its end or until the answers cannot be written.
+void serve(std::istream& in, std::ostream& out, const Instance& instance,
+        const ealain::cost::Population<ealain::camera::Omnidir>& population)
+{
+    std::string line;
+    std::vector<std::vector<double>> batch;
+    std::vector<bool> valid;
+    while(std::getline(in, line)) {
+        // Gather the requests already received.
+        batch.clear();
+        valid.clear();
+        do {
+            if(line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            batch.emplace_back();
+            valid.push_back(parse(line, instance, batch.back()));
+        } while(in.rdbuf()->in_avail() > 0 and std::getline(in, line));
+
+        const std::vector<double> fitnesses = population.coordinates(batch, instance.threads);
+        for(size_t k = 0; k < batch.size(); ++k) {
+            if(valid[k]) {
+                out << fitnesses[k] << "\n";
+            } else {
+                out << "nan\n";
+            }
+        }
+        out.flush();
+        if(not out) {
+            return; // The client left.
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " instance_size [--bits] [--walls file.csv | --instance file.bin] [--socket path] [--threads n]" << std::endl;
+        return 1;
+    }
+    double min_proba = 0.5; // minimum detection proba
+
+    // Read parameters
+    unsigned int n = atoi(argv[1]); // # of points in each dimension
+    bool bits = false;
+    std::string walls;
+    std::string binary;
+    std::string socket_path;
+    size_t threads = 0;
+    for(int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if(arg == "--bits") {
+            bits = true;
+        } else if(arg == "--walls" and i+1 < argc) {
+            walls = argv[++i];
+        } else if(arg == "--instance" and i+1 < argc) {
+            binary = argv[++i];
+        } else if(arg == "--socket" and i+1 < argc) {
+            socket_path = argv[++i];
+        } else if(arg == "--threads" and i+1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Set map, once and for all.
+    int m = static_cast<int>(n);
+    // Cameras revisit the same cells, share their visibility maps (64 MiB at most).
+    Instance instance{n, bits, threads, nullptr};
+    try {
+        instance.shared = not binary.empty()
+            ? ealain::inst::load(binary, 64 << 20)
+            : ealain::inst::share(walls.empty()
+                ? ealain::inst::rectangle(m,m,n,n)
+                : ealain::inst::rectangle_walls(walls,m,m,n,n), 64 << 20);
+    } catch(const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if(instance.shared->rows() != n or instance.shared->cols() != n) {
+        std::cerr << "The instance file should be of size " << n << "x" << n << std::endl;
+        return 1;
+    }
+    ealain::cost::Population<ealain::camera::Omnidir> population(instance.shared, n/2, min_proba);
+
+    // A client leaving before reading its answers fails the writes, instead of killing the server.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if(socket_path.empty()) {
+        // Read the standard input through the same buffer as the sockets,
+        // so that the lines already received can be batched.
+        FdBuffer buffer_in(STDIN_FILENO);
+        FdBuffer buffer_out(STDOUT_FILENO);
+        std::istream in(&buffer_in);
+        std::ostream out(&buffer_out);
+        serve(in, out, instance, population);
+        return 0;
+    }
+
+    const int server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path)-1);
+    ::unlink(socket_path.c_str());
+    if(server < 0
+       or ::bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+       or ::listen(server, 16) != 0) {
+        std::cerr << "Cannot listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    // Clients are served one after the other.
+    while(true) {
+        const int client = ::accept(server, nullptr, nullptr);
+        if(client < 0) {
+            continue;
+        }
+        {
+            FdBuffer buffer(client);
+            std::istream in(&buffer);
+            std::ostream out(&buffer);
+            serve(in, out, instance, population);
+        }
+        ::close(client);
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef __EALAIN_TEST_FIXTURES_H__
+#define __EALAIN_TEST_FIXTURES_H__
+
+/**
+ * Helpers shared by the tests: random instances and errors reporting.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <Ealain/map/instance.h>
+
+// Set each cell of the map to a wall with the given probability, to 0 otherwise, in row-major order.
+inline void random_walls(ealain::inst::Map& map, double density, std::mt19937& rng)
+{
+    std::bernoulli_distribution wall(density);
+    for(auto& row : map) {
+        for(auto& cell : row) {
+            cell = wall(rng) ? 1 : 0;
+        }
+    }
+}
+
+// Map of random walls with the given density.
+inline ealain::inst::Map random_walls(size_t rows, size_t cols, double density, std::mt19937& rng)
+{
+    ealain::inst::Map map(rows, std::vector<double>(cols, 0));
+    random_walls(map, density, rng);
+    return map;
+}
+
+// Print the number of failed checks and return the exit status of the test.
+inline int report(size_t errors)
+{
+    std::cout << errors << " errors" << std::endl;
+    return errors > 0;
+}
+
+#endif // __EALAIN_TEST_FIXTURES_H__
@@ -0,0 +1,157 @@
+/**
+ * Check that bit-packed maps hold the same cells as maps of chars, count and combine them correctly,
+ * and that visibility maps computed into bits, from packed walls or not, are the same as the plain ones.
+ */
+#include <iostream>
+#include <random>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/map/bits.h>
+#include <Ealain/map/geom.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Random chars, with the given density of ones.
+domain::PlanT<char> random_plan(size_t rows, size_t cols, double density, std::mt19937& rng)
+{
+    std::bernoulli_distribution one(density);
+    domain::PlanT<char> plan(rows, cols, 0);
+    for(size_t i=0; i < rows; ++i) {
+        for(size_t j=0; j < cols; ++j) {
+            plan(i,j) = one(rng) ? 1 : 0;
+        }
+    }
+    return plan;
+}
+
+bool same(const domain::Bits& bits, const domain::PlanT<char>& plan)
+{
+    if(bits.rows() != plan.sizes()[0] or bits.cols() != plan.sizes()[1]) {
+        return false;
+    }
+    for(size_t i=0; i < bits.rows(); ++i) {
+        for(size_t j=0; j < bits.cols(); ++j) {
+            if(bits(i,j) != (plan(i,j) != 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    // Packing, counting and cell-wise operations, on widths around word boundaries.
+    for(size_t cols : {1, 63, 64, 65, 130}) {
+        const auto a = random_plan(7, cols, 0.3, rng);
+        const auto b = random_plan(7, cols, 0.6, rng);
+        domain::Bits bits_a(a);
+        if(not same(bits_a, a) or bits_a.count() != static_cast<size_t>(std::count(ALL(a.buffer()), 1))) {
+            std::cerr << "Differing packed map on " << cols << " columns" << std::endl;
+            errors++;
+        }
+
+        domain::PlanT<char> either(7, cols, 0);
+        domain::PlanT<char> both(7, cols, 0);
+        for(size_t i=0; i < 7; ++i) {
+            for(size_t j=0; j < cols; ++j) {
+                either(i,j) = a(i,j) or b(i,j);
+                both(i,j) = a(i,j) and b(i,j);
+            }
+        }
+        domain::Bits bits_either = bits_a;
+        bits_either |= domain::Bits(b);
+        domain::Bits bits_both = bits_a;
+        bits_both &= domain::Bits(b);
+        if(not same(bits_either, either) or not same(bits_both, both)) {
+            std::cerr << "Differing union or intersection on " << cols << " columns" << std::endl;
+            errors++;
+        }
+
+        domain::Bits full(7, cols, true);
+        if(full.count() != 7 * cols) {
+            std::cerr << "Set padding bits on " << cols << " columns" << std::endl;
+            errors++;
+        }
+
+        domain::Bits spans(7, cols);
+        domain::PlanT<char> cells(7, cols, 0);
+        for(size_t i=0; i < 7; ++i) {
+            const size_t first = std::uniform_int_distribution<size_t>(0, cols)(rng);
+            const size_t last = std::uniform_int_distribution<size_t>(first, cols)(rng);
+            spans.set(i, first, last);
+            for(size_t j=first; j < last; ++j) {
+                cells(i,j) = 1;
+            }
+        }
+        if(not same(spans, cells)) {
+            std::cerr << "Differing spans on " << cols << " columns" << std::endl;
+            errors++;
+        }
+
+        std::vector<double> values(cols);
+        bits_a.expand(3, values.data());
+        for(size_t j=0; j < cols; ++j) {
+            if(values[j] != a(3,j)) {
+                std::cerr << "Differing expanded row on " << cols << " columns" << std::endl;
+                errors++;
+                break;
+            }
+        }
+    }
+
+    // Union of smaller maps at any offset.
+    domain::PlanT<char> merged(20, 200, 0);
+    domain::Bits bits_merged(20, 200);
+    std::uniform_int_distribution<size_t> rows(1, 10);
+    std::uniform_int_distribution<size_t> cols(1, 100);
+    for(size_t k=0; k < 50; ++k) {
+        const auto part = random_plan(rows(rng), cols(rng), 0.5, rng);
+        const size_t row = std::uniform_int_distribution<size_t>(0, 20 - part.sizes()[0])(rng);
+        const size_t col = std::uniform_int_distribution<size_t>(0, 200 - part.sizes()[1])(rng);
+        for(size_t i=0; i < part.sizes()[0]; ++i) {
+            for(size_t j=0; j < part.sizes()[1]; ++j) {
+                merged(row+i, col+j) |= part(i,j);
+            }
+        }
+        bits_merged.merge(domain::Bits(part), row, col);
+    }
+    if(not same(bits_merged, merged)) {
+        std::cerr << "Differing merged map" << std::endl;
+        errors++;
+    }
+
+    // Visibility maps, in windows, from the map and from packed walls.
+    const size_t n = 23;
+    const size_t m = 37;
+    const inst::Map map = random_walls(n, m, 0.15, rng);
+    const domain::Bits walls = geom::walls(map);
+    for(size_t i=0; i < n; ++i) {
+        for(size_t j=0; j < m; ++j) {
+            const geom::Box window{i > 6 ? i-6 : 0, j > 9 ? j-9 : 0, std::min(i+6, n-1), std::min(j+9, m-1)};
+            for(geom::Visibility engine : {geom::Visibility::ray_tracing, geom::Visibility::sweep}) {
+                domain::PlanT<char> plain(window.rows(), window.cols(), 0);
+                domain::Bits from_map(window.rows(), window.cols());
+                domain::Bits from_walls(window.rows(), window.cols());
+                const unsigned int n_plain = geom::visibility_map_2D(plain, map, i, j, window, engine);
+                const unsigned int n_map = geom::visibility_map_2D(from_map, map, i, j, window, engine);
+                const unsigned int n_walls = geom::visibility_map_2D(from_walls, walls, i, j, window, engine);
+                if(n_plain != n_map or n_plain != n_walls or n_plain != from_map.count()
+                   or not same(from_map, plain) or from_map != from_walls) {
+                    std::cerr << "Differing bit-packed visibility from " << i << "," << j << std::endl;
+                    errors++;
+                }
+            }
+        }
+    }
+
+    return report(errors);
+}
@@ -33,5 +33,14 @@ int main()
     auto cover = ealain::cost::make_coverage(dom, min_proba);
     double sum = cover(group);
     std::cout << sum << std::endl;
+
+    // Raising the range after construction also grows the visibility box.
+    ealain::camera::Omnidir camera_1(map, p_map, m/2, m/2, 1);
+    camera_1.range(m);
+    const ealain::geom::Box box = camera_1.footprint();
+    if(box.rows() != n or box.cols() != n) {
+        std::cerr << "Visibility box not updated by range: " << box.rows() << "x" << box.cols() << std::endl;
+        return 1;
+    }
 }
 
@@ -0,0 +1,115 @@
+/**
+ * Check that the bit-packed coverage of groups of binary cameras
+ * gives exactly the same domain and coverage as evaluating the groups.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Compare the bit-packed coverage with the evaluation of the group, return the number of errors.
+size_t compare(group::Group& group, const proj::Projection<double,size_t>& p, double threshold, bool expect_binary)
+{
+    domain::Plan evaluated(p, 0);
+    group.evaluate(evaluated);
+    double expected = 0;
+    for(const double cell : evaluated.buffer()) {
+        if(cell >= threshold) {
+            expected++;
+        }
+    }
+
+    domain::Plan packed(p, -1);
+    double covered = -1;
+    group.prepare();
+    const bool binary = cost::binary_coverage(group, packed, threshold, covered);
+    if(binary != expect_binary) {
+        std::cerr << "Unexpected bit-packed evaluation: " << binary << std::endl;
+        return 1;
+    }
+    if(binary and (covered != expected or not std::equal(ALL(evaluated.buffer()), std::begin(packed.buffer())))) {
+        std::cerr << "Differing coverage: " << covered << " instead of " << expected << std::endl;
+        return 1;
+    }
+
+    // Coverage selects the bit-packed evaluation by itself.
+    domain::Plan domain(p, 0);
+    auto cover = cost::make_coverage(domain, threshold);
+    if(cover(group) != expected) {
+        std::cerr << "Differing Coverage" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    // Widths around word boundaries,
+    // with cells falling on the pixels of the visibility maps (unit steps) or not.
+    for(size_t k : {20, 64, 97})
+    for(bool unit : {false, true}) {
+        size_t n = 41;
+        auto d = unit ? inst::rectangle(n, k, 0, n-1, 0, k-1) : inst::rectangle(n, k, n, k);
+        inst::Map map = d.first;
+        proj::Projection<double,size_t> p_map = d.second;
+        random_walls(map, 0.1, rng);
+
+        // Cameras anywhere, with ranges falling on cells or not.
+        std::uniform_real_distribution<double> x(0, n-1);
+        std::uniform_real_distribution<double> y(0, k-1);
+        std::uniform_int_distribution<int> cell(0, std::min(n, k)-1);
+        for(size_t step=0; step < 20; ++step) {
+            std::vector<camera::Omnibinary> cameras;
+            for(size_t c=0; c < 5; ++c) {
+                const double range = step % 2 ? cell(rng) : x(rng) / 2;
+                if(c % 2) {
+                    cameras.emplace_back(map, p_map, cell(rng), cell(rng), range);
+                } else {
+                    cameras.emplace_back(map, p_map, x(rng), y(rng), range);
+                }
+            }
+            group::proba::AtLeastOne at_least_one(p_map, 0.05, 0.95);
+            group::Binary binary(p_map);
+            group::Binary negative(p_map, -1);
+            group::Binary high(p_map, 1);
+            for(auto& camera : cameras) {
+                at_least_one.bind(camera);
+                binary.bind(camera);
+                negative.bind(camera);
+                high.bind(camera);
+            }
+            for(double threshold : {0.0, 0.05, 0.5, 0.95, 1.0}) {
+                errors += compare(at_least_one, p_map, threshold, true);
+                errors += compare(binary, p_map, threshold, true);
+                errors += compare(negative, p_map, threshold, true);
+                errors += compare(high, p_map, threshold, true);
+            }
+        }
+
+        // Groups with other cameras are evaluated as usual.
+        camera::Omnibinary bin(map, p_map, x(rng), y(rng), n/3.0);
+        camera::Omnidir dir(map, p_map, x(rng), y(rng), n/3.0);
+        group::proba::AtLeastOne mixed(p_map, {bin, dir});
+        errors += compare(mixed, p_map, 0.5, false);
+        group::Additive additive(p_map, {bin});
+        errors += compare(additive, p_map, 0.5, false);
+        group::proba::AtLeastOne empty(p_map);
+        errors += compare(empty, p_map, 0.0, true);
+    }
+
+    return report(errors);
+}
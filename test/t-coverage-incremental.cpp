@@ -0,0 +1,71 @@
+/**
+ * Check that updating the coverage incrementally when cameras move
+ * gives exactly the same domain and coverage as a full evaluation.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 40;
+    double m = 40;
+    auto d = inst::rectangle(n,n,m,m);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+
+    // Some walls.
+    random_walls(map, 0.1, rng);
+
+    std::uniform_real_distribution<double> coord(0, m-1);
+    std::vector<camera::Omnidir> cameras;
+    for(size_t c=0; c < 6; ++c) {
+        cameras.emplace_back(map, p_map, coord(rng), coord(rng), m/5);
+    }
+    group::proba::AtLeastOne group(p_map);
+    for(auto& cam : cameras) {
+        group.bind(cam);
+    }
+
+    const double min_proba = 0.5;
+    camera::Omnidir::Domain dom_incr(n,n,0);
+    cost::IncrementalCoverage incremental(dom_incr, group, min_proba);
+    incremental();
+
+    std::uniform_int_distribution<size_t> which(0, cameras.size()-1);
+    for(size_t step=0; step < 200; ++step) {
+        const size_t c = which(rng);
+        cameras[c].geo.x = coord(rng);
+        cameras[c].geo.y = coord(rng);
+        cameras[c].geo.update();
+        const double value = incremental.moved(c);
+
+        camera::Omnidir::Domain dom_full(n,n,0);
+        auto cover = cost::make_coverage(dom_full, min_proba);
+        const double expected = cover(group);
+
+        if(value != expected
+           or not std::equal(ALL(dom_full.buffer()), std::begin(dom_incr.buffer()))) {
+            std::cerr << "Differing coverage at step " << step << ": "
+                      << value << " instead of " << expected << std::endl;
+            errors++;
+        }
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,87 @@
+/**
+ * Check that counting the coverage while streaming rows, without writing the domain,
+ * gives the same coverage as evaluating the group in the domain.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 57;
+    size_t k = 43;
+    auto d = inst::rectangle(n,k,n,k);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    random_walls(map, 0.1, rng);
+
+    std::uniform_real_distribution<double> x(0, n-1);
+    std::uniform_real_distribution<double> y(0, k-1);
+    std::vector<camera::Omnidir> cameras;
+    for(size_t c=0; c < 6; ++c) {
+        cameras.emplace_back(map, p_map, x(rng), y(rng), n/4.0);
+    }
+    camera::Omnibinary binary_camera(map, p_map, x(rng), y(rng), n/5.0);
+
+    group::proba::AtLeastOne at_least_one(p_map, 0.1, 0.9);
+    group::Additive additive(p_map);
+    group::Max max(p_map);
+    group::Binary binary(p_map, 0.2);
+    group::Aggregate custom(p_map, 0.5, [](const double& lhs, const double& rhs) {return lhs * 0.5 + rhs;});
+    std::vector<group::Group*> groups = {&at_least_one, &additive, &max, &binary, &custom};
+    for(group::Group* g : groups) {
+        for(auto& camera : cameras) {
+            g->bind(camera);
+        }
+        g->bind(binary_camera);
+    }
+
+    for(group::Group* g : groups) {
+        for(double threshold : {0.0, 0.3, 0.6}) {
+            domain::Plan evaluated(p_map, 0);
+            auto stored = cost::make_coverage(evaluated, threshold);
+            const double expected = stored(*g);
+
+            domain::Plan untouched(p_map, -1);
+            cost::Coverage<domain::Plan> streamed(untouched, threshold, false);
+            const double covered = streamed(*g);
+            if(covered != expected) {
+                std::cerr << "Differing streamed coverage: " << covered << " instead of " << expected << std::endl;
+                errors++;
+            }
+
+            // Only groups without row evaluation write the domain.
+            const bool written = std::any_of(ALL(untouched.buffer()), [](double cell) {return cell != -1;});
+            if(written and g != &custom) {
+                std::cerr << "Domain written in reduction-only mode" << std::endl;
+                errors++;
+            }
+
+            for(size_t threads : {2, 5}) {
+                double counted = -1;
+                g->prepare();
+                if(g->count(n, k, threshold, counted, threads) and counted != expected) {
+                    std::cerr << "Differing count on " << threads << " threads" << std::endl;
+                    errors++;
+                }
+            }
+        }
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,74 @@
+/**
+ * Check that evaluating detectors and groups across several threads
+ * gives exactly the same domains as a single-threaded evaluation.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Evaluate with several numbers of threads, return the number of differing results.
+template<class S>
+size_t compare(S& sensor, size_t rows, size_t cols, const std::string& name)
+{
+    size_t errors = 0;
+    domain::Plan expected(rows, cols, 0);
+    sensor.evaluate(expected, 1);
+    for(size_t threads : {2, 3, 7, 0}) {
+        domain::Plan out(rows, cols, -1);
+        sensor.evaluate(out, threads);
+        if(not std::equal(ALL(expected.buffer()), std::begin(out.buffer()))) {
+            std::cerr << "Differing " << name << " with " << threads << " threads" << std::endl;
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 37;
+    size_t k = 29;
+    auto d = inst::rectangle(n,k,n,k);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    random_walls(map, 0.1, rng);
+
+    std::uniform_real_distribution<double> x(0, n-1);
+    std::uniform_real_distribution<double> y(0, k-1);
+    std::vector<camera::Omnidir> cameras;
+    for(size_t c=0; c < 5; ++c) {
+        cameras.emplace_back(map, p_map, x(rng), y(rng), n/3.0);
+    }
+    camera::Omnibinary binary(map, p_map, x(rng), y(rng), n/4.0);
+
+    group::proba::AtLeastOne at_least_one(p_map);
+    group::Max max(p_map);
+    group::Binary threshold(p_map, 0.3);
+    for(auto& cam : cameras) {
+        at_least_one.bind(cam);
+        max.bind(cam);
+        threshold.bind(cam);
+    }
+    at_least_one.bind(binary);
+
+    errors += compare(cameras[0], n, k, "camera");
+    errors += compare(at_least_one, n, k, "AtLeastOne");
+    errors += compare(max, n, k, "Max");
+    errors += compare(threshold, n, k, "Binary");
+
+    return report(errors);
+}
@@ -0,0 +1,98 @@
+/**
+ * Check that a binary instance file gives back the same walls, ranges and coverages,
+ * without building the dense map until asked for.
+ */
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/shared.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    // Columns not a multiple of the words size, ranges not starting at zero.
+    const size_t rows = 45, cols = 70;
+    auto d = inst::rectangle(rows, cols, -5, 40, 10, 80);
+    random_walls(d.first, 0.05, rng);
+    const inst::Map map = d.first;
+    const inst::Shared original = inst::share(std::move(d));
+
+    inst::save("t-instance-file.bin", *original);
+    const inst::Shared loaded = inst::load("t-instance-file.bin", 1 << 24);
+    if(loaded->rows() != rows or loaded->cols() != cols or loaded->walls() != original->walls()
+       or loaded->cache() == nullptr) {
+        std::cerr << "Differing walls" << std::endl;
+        errors++;
+    }
+    for(size_t d=0; d < 2; ++d) {
+        if(loaded->projection()[d].range_irl().min() != original->projection()[d].range_irl().min()
+           or loaded->projection()[d].range_irl().max() != original->projection()[d].range_irl().max()
+           or loaded->projection()[d].range_idx().max() != original->projection()[d].range_idx().max()) {
+            std::cerr << "Differing range on axis " << d << std::endl;
+            errors++;
+        }
+    }
+
+    // Coverages only read the walls.
+    std::uniform_real_distribution<double> x(-5, 40);
+    std::uniform_real_distribution<double> y(10, 80);
+    std::vector<std::vector<double>> layouts(8);
+    for(auto& layout : layouts) {
+        for(size_t c=0; c < 4; ++c) {
+            layout.push_back(x(rng));
+            layout.push_back(y(rng));
+        }
+    }
+    cost::Population<camera::Omnidir> plain(map, original->projection(), 20, 0.5);
+    cost::Population<camera::Omnidir> file(loaded, 20, 0.5);
+    if(file.coordinates(layouts, 2) != plain.coordinates(layouts, 2)) {
+        std::cerr << "Differing coverages" << std::endl;
+        errors++;
+    }
+
+    // Dense map built on demand.
+    camera::Omnidir camera(loaded, 10, 40, 20);
+    if(camera.geo.map() != map or loaded->map() != map) {
+        std::cerr << "Differing dense map" << std::endl;
+        errors++;
+    }
+
+    // Unreadable, truncated or corrupt files are reported.
+    std::ifstream in("t-instance-file.bin", std::ios::binary);
+    const std::string valid((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::ofstream("t-instance-file-truncated.bin", std::ios::binary) << valid.substr(0, valid.size() - 8);
+    std::ofstream("t-instance-file-header.bin", std::ios::binary) << valid.substr(0, 60);
+    std::string version = valid;
+    version[8] = 2;
+    std::ofstream("t-instance-file-version.bin", std::ios::binary) << version;
+    for(const char* filename : {"t-instance-file-missing.bin", "t-instance-file-truncated.bin",
+                                "t-instance-file-header.bin", "t-instance-file-version.bin"}) {
+        try {
+            inst::load(filename);
+            std::cerr << "Unreported bad instance file " << filename << std::endl;
+            errors++;
+        } catch(const std::runtime_error&) {}
+    }
+    try {
+        inst::save("t-instance-file-missing/instance.bin", *original);
+        std::cerr << "Unreported unwritable instance file" << std::endl;
+        errors++;
+    } catch(const std::runtime_error&) {}
+
+    return report(errors);
+}
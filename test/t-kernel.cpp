@@ -0,0 +1,172 @@
+/**
+ * Check that the row kernels give the same results on every instruction set,
+ * that cameras evaluated by rows see the same as on each cell,
+ * and that groups evaluated by rows give the same domains as calling them on each cell.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/kernel.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+bool same(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return a.size() == b.size() and std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+// Run all the kernels on the same data, concatenate the results.
+std::vector<double> run(const std::vector<double>& cells, const std::vector<double>& values)
+{
+    std::vector<double> all;
+    for(kernel::Row k : {kernel::complement_product, kernel::sum, kernel::product, kernel::less, kernel::greater}) {
+        std::vector<double> c = cells;
+        k(c.data(), values.data(), c.size());
+        all.insert(std::end(all), ALL(c));
+    }
+    std::vector<double> c = cells;
+    kernel::threshold(c.data(), values.data(), c.size(), 0.4);
+    all.insert(std::end(all), ALL(c));
+    c = cells;
+    kernel::at_least_one(c.data(), c.size(), 0.1, 0.9);
+    all.insert(std::end(all), ALL(c));
+    return all;
+}
+
+// Domain computed by calling the group on each cell.
+domain::Plan by_cell(sensor::Detector& group, const proj::Projection<double,size_t>& p, size_t rows, size_t cols)
+{
+    domain::Plan out(rows, cols, 0);
+    for(size_t i=0; i < rows; ++i) {
+        for(size_t j=0; j < cols; ++j) {
+            out(i,j) = group(Position{p[0](i), p[1](j)});
+        }
+    }
+    return out;
+}
+
+// Compare the rows of a camera with calling it on each cell, return the number of differing rows.
+size_t compare_rows(sensor::Detector& cam, const proj::Projection<double,size_t>& p, size_t rows, size_t cols)
+{
+    size_t errors = 0;
+    const std::vector<double> ys = p.axis(1, cols);
+    std::vector<double> values(cols);
+    for(size_t i=0; i < rows; ++i) {
+        cam.row(p[0](i), ys.data(), cols, values.data());
+        for(size_t j=0; j < cols; ++j) {
+            if(values[j] != cam(Position{p[0](i), ys[j]})) {
+                errors++;
+                break;
+            }
+        }
+    }
+    return errors;
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    // Kernels, on sizes not multiple of the vectors widths.
+    std::uniform_real_distribution<double> proba(-0.1, 1.1);
+    std::vector<double> cells(1003);
+    std::vector<double> values(cells.size());
+    for(size_t j=0; j < cells.size(); ++j) {
+        cells[j] = proba(rng);
+        values[j] = j % 7 == 0 ? 0 : proba(rng);
+    }
+    const kernel::ISA best = kernel::best();
+    kernel::isa(kernel::ISA::scalar);
+    const std::vector<double> expected = run(cells, values);
+    for(kernel::ISA set : {kernel::ISA::avx2, kernel::ISA::avx512}) {
+        if(kernel::isa(set) and not same(run(cells, values), expected)) {
+            std::cerr << "Differing kernels with instruction set " << static_cast<int>(set) << std::endl;
+            errors++;
+        }
+    }
+    kernel::isa(best);
+
+    // Groups.
+    size_t n = 33;
+    size_t k = 27;
+    auto d = inst::rectangle(n,k,n,k);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    random_walls(map, 0.1, rng);
+    std::uniform_real_distribution<double> x(0, n-1);
+    std::uniform_real_distribution<double> y(0, k-1);
+    camera::Omnidir cam_0(map, p_map, x(rng), y(rng), n/3.0);
+    camera::Omnidir cam_1(map, p_map, x(rng), y(rng), n/3.0);
+    camera::Omnibinary cam_2(map, p_map, x(rng), y(rng), n/4.0);
+
+    // Cameras on cells, with ranges falling exactly on cells, or too small to be guarded.
+    for(kernel::ISA set : {kernel::ISA::scalar, kernel::ISA::avx2, kernel::ISA::avx512}) {
+        if(not kernel::isa(set)) {
+            continue;
+        }
+        for(double range : {0.0, 1e-6, 1.0, 5.0, 7.0 + 1e-6, 13.0, x(rng)}) {
+            camera::Omnidir dir(map, p_map, 16, 13, range);
+            camera::Omnibinary bin(map, p_map, x(rng), y(rng), range);
+            camera::Omnibinary on(map, p_map, 16, 13, range);
+            const size_t differing = compare_rows(dir, p_map, n, k) + compare_rows(bin, p_map, n, k) + compare_rows(on, p_map, n, k);
+            if(differing > 0) {
+                std::cerr << "Differing camera rows with instruction set " << static_cast<int>(set) << " and range " << range << std::endl;
+                errors += differing;
+            }
+        }
+    }
+    kernel::isa(best);
+
+    group::proba::AtLeastOne at_least_one(p_map, {cam_0, cam_1, cam_2}, 0.05, 0.95);
+    group::Additive additive(p_map, {cam_0, cam_1, cam_2});
+    group::Multiplicative multiplicative(p_map, {cam_0, cam_1, cam_2});
+    group::Min min(p_map, {cam_0, cam_1, cam_2});
+    group::Max max(p_map, {cam_0, cam_1, cam_2});
+    group::Binary binary(p_map, {cam_0, cam_1, cam_2}, 0.3);
+    group::Binary negative(p_map, {cam_0, cam_1, cam_2}, -1);
+    group::Aggregate custom(p_map, {cam_0, cam_1, cam_2}, 0.5,
+            [](const double& lhs, const double& rhs) {return lhs * 0.5 + rhs;});
+
+    for(kernel::ISA set : {kernel::ISA::scalar, kernel::ISA::avx2, kernel::ISA::avx512}) {
+        if(not kernel::isa(set)) {
+            continue;
+        }
+        for(group::Group* g : std::vector<group::Group*>{&at_least_one, &additive, &multiplicative, &min, &max, &binary, &negative, &custom}) {
+            domain::Plan out(n, k, -1);
+            g->evaluate(out, 2);
+            domain::Plan expected = by_cell(*g, p_map, n, k);
+            if(not std::equal(ALL(expected.buffer()), std::begin(out.buffer()))) {
+                std::cerr << "Differing group evaluation with instruction set " << static_cast<int>(set) << std::endl;
+                errors++;
+            }
+        }
+    }
+
+    // Cameras on a coarser discretisation of the same area, which footprints are not in the indices of the group.
+    auto coarse = inst::rectangle(n/2, k/2, n, k);
+    camera::Omnidir cam_coarse(coarse.first, coarse.second, x(rng), y(rng), n/3.0);
+    group::proba::AtLeastOne mixed(p_map, {cam_0, cam_coarse}, 0.05, 0.95);
+    group::Binary mixed_binary(p_map, {cam_coarse, cam_2}, 0.3);
+    for(group::Group* g : std::vector<group::Group*>{&mixed, &mixed_binary}) {
+        domain::Plan out(n, k, -1);
+        g->evaluate(out);
+        domain::Plan expected = by_cell(*g, p_map, n, k);
+        if(not std::equal(ALL(expected.buffer()), std::begin(out.buffer()))) {
+            std::cerr << "Differing group evaluation with another discretisation" << std::endl;
+            errors++;
+        }
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,108 @@
+/**
+ * Check that evaluating a population of layouts at once
+ * gives the same fitnesses as separate coverages.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/cache.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Coverage of cameras at the given real-world coordinates, evaluated the usual way.
+double coverage(const inst::Map& map, proj::Projection<double,size_t>& p_map,
+        const std::vector<std::array<double,2>>& positions, double range, double min_proba)
+{
+    std::vector<camera::Omnidir> cameras;
+    for(const auto& xy : positions) {
+        cameras.emplace_back(map, p_map, xy[0], xy[1], range);
+    }
+    group::proba::AtLeastOne group(p_map);
+    for(auto& cam : cameras) {
+        group.bind(cam);
+    }
+    camera::Omnidir::Domain domain(p_map);
+    auto cover = cost::make_coverage(domain, min_proba);
+    return cover(group);
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 24;
+    double m = 24;
+    auto d = inst::rectangle(n,n,m,m);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    random_walls(map, 0.1, rng);
+    const double range = m/3;
+    const double min_proba = 0.5;
+
+    // Normalized layouts.
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<std::vector<double>> layouts(30, std::vector<double>(8));
+    for(auto& layout : layouts) {
+        for(auto& v : layout) {
+            v = unit(rng);
+        }
+    }
+    // Bitstrings.
+    std::bernoulli_distribution bit(0.01);
+    std::vector<std::vector<bool>> bitstrings(30, std::vector<bool>(n*n));
+    for(auto& layout : bitstrings) {
+        for(size_t c=0; c < layout.size(); ++c) {
+            layout[c] = bit(rng);
+        }
+    }
+
+    std::vector<double> expected_num;
+    for(const auto& layout : layouts) {
+        std::vector<std::array<double,2>> xy;
+        for(size_t c=0; c < layout.size(); c+=2) {
+            xy.push_back({layout[c] * m, layout[c+1] * m});
+        }
+        expected_num.push_back(coverage(map, p_map, xy, range, min_proba));
+    }
+    std::vector<double> expected_bits;
+    for(const auto& layout : bitstrings) {
+        std::vector<std::array<double,2>> xy;
+        for(size_t c=0; c < layout.size(); ++c) {
+            if(layout[c]) {
+                xy.push_back({p_map[0](c / n), p_map[1](c % n)});
+            }
+        }
+        expected_bits.push_back(coverage(map, p_map, xy, range, min_proba));
+    }
+
+    geom::VisibilityCache cache(map, 1 << 20);
+    cost::Population<camera::Omnidir> alone(map, p_map, range, min_proba);
+    cost::Population<camera::Omnidir> shared(map, p_map, range, min_proba, &cache);
+    for(size_t threads : {1, 4}) {
+        for(auto* population : {&alone, &shared}) {
+            if(population->numeric(layouts, threads) != expected_num) {
+                std::cerr << "Differing numeric fitnesses with " << threads << " threads" << std::endl;
+                errors++;
+            }
+            if(population->bits(bitstrings, threads) != expected_bits) {
+                std::cerr << "Differing bitstring fitnesses with " << threads << " threads" << std::endl;
+                errors++;
+            }
+        }
+    }
+    if(cache.hits() == 0) {
+        std::cerr << "Cache never hit" << std::endl;
+        errors++;
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,149 @@
+/**
+ * Check that coarser levels of a pyramid keep all the walls,
+ * and that visibility maps pruned with the coarse levels are exactly the traced ones,
+ * so that a layout has the same coverage at any level with or without the pyramid caches.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/geom.h>
+#include <Ealain/map/cache.h>
+#include <Ealain/map/pyramid.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Check levels sizes, walls and wall queries against brute force.
+size_t check_levels(const inst::Pyramid& pyramid, std::mt19937& rng)
+{
+    size_t errors = 0;
+    for(size_t k=1; k < pyramid.levels(); ++k) {
+        const domain::Bits& fine = pyramid.walls(k-1);
+        const domain::Bits& coarse = pyramid.walls(k);
+        if(coarse.rows() != (fine.rows()+1)/2 or coarse.cols() != (fine.cols()+1)/2
+           or pyramid.map(k).size() != coarse.rows()
+           or pyramid.projection(k)[0].range_idx().max() != coarse.rows()-1) {
+            std::cerr << "Unexpected sizes of level " << k << std::endl;
+            errors++;
+            continue;
+        }
+        for(size_t i=0; i < fine.rows(); ++i) {
+            for(size_t j=0; j < fine.cols(); ++j) {
+                if(fine(i,j) and not coarse(i/2,j/2)) {
+                    std::cerr << "Wall " << i << "," << j << " lost at level " << k << std::endl;
+                    errors++;
+                }
+            }
+        }
+    }
+    for(size_t k=0; k < pyramid.levels(); ++k) {
+        const domain::Bits& cells = pyramid.walls(k);
+        std::uniform_int_distribution<size_t> row(0, cells.rows()-1);
+        std::uniform_int_distribution<size_t> col(0, cells.cols()-1);
+        for(size_t b=0; b < 200; ++b) {
+            size_t i0 = row(rng), i1 = row(rng), j0 = col(rng), j1 = col(rng);
+            const geom::Box box{std::min(i0,i1), std::min(j0,j1), std::max(i0,i1), std::max(j0,j1)};
+            bool expected = false;
+            for(size_t i=box.row_min; i <= box.row_max; ++i) {
+                for(size_t j=box.col_min; j <= box.col_max; ++j) {
+                    expected = expected or cells(i,j);
+                }
+            }
+            if(pyramid.walled(k, box) != expected) {
+                std::cerr << "Wrong walls query at level " << k << std::endl;
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+// Compare pruned and traced visibility from every cell of a level, within windows of the given radius.
+size_t check_visibility(const inst::Pyramid& pyramid, size_t level, size_t radius)
+{
+    size_t errors = 0;
+    const domain::Bits& cells = pyramid.walls(level);
+    for(geom::Visibility engine : {geom::Visibility::sweep, geom::Visibility::ray_tracing}) {
+        for(size_t i=0; i < cells.rows(); ++i) {
+            for(size_t j=0; j < cells.cols(); ++j) {
+                const geom::Box window{
+                    i > radius ? i-radius : 0,
+                    j > radius ? j-radius : 0,
+                    std::min(i+radius, cells.rows()-1),
+                    std::min(j+radius, cells.cols()-1)};
+                domain::Bits traced(window.rows(), window.cols());
+                domain::Bits pruned(window.rows(), window.cols());
+                geom::visibility_map_2D(traced, cells, i, j, window, engine);
+                const unsigned int seen = pyramid.visibility(pruned, level, i, j, window, engine);
+                if(pruned != traced or seen != traced.count()) {
+                    std::cerr << "Differing visibility at level " << level << " from " << i << "," << j << std::endl;
+                    errors++;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    for(double density : {0.0, 0.02, 0.3}) {
+        for(size_t n : {24, 29}) {
+            auto d = inst::rectangle(n, n, n, n);
+            inst::Pyramid pyramid(random_walls(n, n, density, rng), d.second, 4);
+            if(pyramid.levels() != 4) {
+                std::cerr << "Unexpected number of levels" << std::endl;
+                errors++;
+            }
+            errors += check_levels(pyramid, rng);
+            errors += check_visibility(pyramid, 0, 5);
+            errors += check_visibility(pyramid, 1, n);
+        }
+    }
+
+    // Non-square maps, down to a single cell.
+    auto d = inst::rectangle(23, 9, 23, 9);
+    inst::Pyramid thin(random_walls(23, 9, 0.05, rng), d.second, 10);
+    if(thin.levels() != 6 or thin.walls(5).rows() != 1 or thin.walls(5).cols() != 1) {
+        std::cerr << "Unexpected levels of a non-square map" << std::endl;
+        errors++;
+    }
+    errors += check_levels(thin, rng);
+    errors += check_visibility(thin, 0, 5);
+
+    // Same coverages at each level with the pyramid caches as on plain maps.
+    size_t n = 64;
+    double m = 64;
+    auto dm = inst::rectangle(n, n, m, m);
+    inst::Pyramid pyramid(random_walls(n, n, 0.02, rng), dm.second, 4);
+    std::uniform_real_distribution<double> coord(0, m);
+    std::vector<std::vector<double>> layouts(8);
+    for(auto& layout : layouts) {
+        for(size_t c=0; c < 2*5; ++c) {
+            layout.push_back(coord(rng));
+        }
+    }
+    for(size_t k=0; k < pyramid.levels(); ++k) {
+        geom::VisibilityCache cache(pyramid, k, 1 << 24);
+        inst::Map map = pyramid.map(k);
+        proj::Projection<double,size_t> p = pyramid.projection(k);
+        cost::Population<camera::Omnidir> shared(pyramid.map(k), pyramid.projection(k), m/4, 0.5, &cache);
+        cost::Population<camera::Omnidir> plain(map, p, m/4, 0.5);
+        if(shared.coordinates(layouts, 2) != plain.coordinates(layouts, 2)) {
+            std::cerr << "Differing coverage at level " << k << std::endl;
+            errors++;
+        }
+    }
+
+    return report(errors);
+}
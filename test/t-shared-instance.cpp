@@ -0,0 +1,125 @@
+/**
+ * Check that a shared instance does not copy its map, is kept alive by the cameras using it,
+ * and gives the same coverages as a plain map, from several threads.
+ */
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/shared.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 40;
+    double m = 40;
+    auto d = inst::rectangle(n,n,m,m);
+    random_walls(d.first, 0.05, rng);
+    const inst::Map plain_map = d.first;
+    const proj::Projection<double,size_t> plain_proj = d.second;
+
+    // Moved in, not copied.
+    const double* cells = d.first[0].data();
+    inst::Shared instance = inst::share(std::move(d), 1 << 24);
+    if(instance->map()[0].data() != cells or instance->map() != plain_map
+       or instance->walls() != geom::walls(plain_map) or instance->cache() == nullptr) {
+        std::cerr << "Unexpected shared instance" << std::endl;
+        errors++;
+    }
+
+    // Cameras keep the instance alive.
+    std::weak_ptr<const inst::Instance> alive = instance;
+    {
+        camera::Omnidir held(instance, 10, 20, m/3);
+        instance.reset();
+        camera::Omnidir plain(plain_map, plain_proj, 10, 20, m/3);
+        camera::Omnidir::Domain dom_held(n,n,0);
+        camera::Omnidir::Domain dom_plain(n,n,0);
+        dom_held = held(dom_held);
+        dom_plain = plain(dom_plain);
+        if(alive.expired() or not std::equal(ALL(dom_held.buffer()), std::begin(dom_plain.buffer()))) {
+            std::cerr << "Instance released while used" << std::endl;
+            errors++;
+        }
+    }
+    if(not alive.expired()) {
+        std::cerr << "Instance not released" << std::endl;
+        errors++;
+    }
+
+    // Same coverages from several threads sharing an instance and its cache.
+    instance = inst::share(inst::rectangle_walls("", n, n, m, m), 1 << 24);
+    std::uniform_real_distribution<double> coord(0, m);
+    std::vector<std::vector<double>> layouts(16);
+    for(auto& layout : layouts) {
+        for(size_t c=0; c < 2*4; ++c) {
+            layout.push_back(coord(rng));
+        }
+    }
+    std::vector<double> expected(layouts.size());
+    for(size_t l=0; l < layouts.size(); ++l) {
+        camera::Omnidir::Domain domain(n,n,0);
+        group::proba::AtLeastOne group(plain_proj);
+        std::vector<camera::Omnidir> cameras;
+        for(size_t c=0; c < layouts[l].size(); c += 2) {
+            cameras.emplace_back(instance->map(), plain_proj, layouts[l][c], layouts[l][c+1], m/4);
+        }
+        for(auto& camera : cameras) {
+            group.bind(camera);
+        }
+        expected[l] = cost::make_coverage(domain, 0.5)(group);
+    }
+    std::vector<size_t> thread_errors(4, 0);
+    std::vector<std::thread> threads;
+    for(size_t t=0; t < thread_errors.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            for(size_t l=t; l < layouts.size(); l += thread_errors.size()) {
+                camera::Omnidir::Domain domain(instance->projection());
+                group::proba::AtLeastOne group(instance->projection());
+                std::vector<camera::Omnidir> cameras;
+                for(size_t c=0; c < layouts[l].size(); c += 2) {
+                    cameras.emplace_back(instance, layouts[l][c], layouts[l][c+1], m/4);
+                }
+                for(auto& camera : cameras) {
+                    group.bind(camera);
+                }
+                if(cost::make_coverage(domain, 0.5)(group) != expected[l]) {
+                    thread_errors[t]++;
+                }
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(size_t e : thread_errors) {
+        errors += e;
+    }
+    if(instance->cache()->hits() + instance->cache()->misses() != layouts.size() * 4) {
+        std::cerr << "Cache of the instance not used" << std::endl;
+        errors++;
+    }
+
+    cost::Population<camera::Omnidir> shared(instance, m/4, 0.5);
+    if(shared.coordinates(layouts, 2) != expected) {
+        std::cerr << "Differing population coverage" << std::endl;
+        errors++;
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,127 @@
+/**
+ * Check that the instrumentation counts each phase, across threads,
+ * consistently with the visibility cache counters, and that it counts nothing when disabled.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/trace.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/cache.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+trace::Counter total(trace::Phase phase)
+{
+    return trace::totals()[static_cast<size_t>(phase)];
+}
+
+int main()
+{
+    size_t errors = 0;
+
+    size_t n = 20;
+    double m = 20;
+    auto d = inst::rectangle(n,n,m,m);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    for(size_t i=5; i < 15; ++i) {
+        map[i][10] = 1;
+    }
+    geom::VisibilityCache cache(map, 100 * n * n);
+
+    trace::reset();
+
+    // Two coverages of the same cameras, the second one only hitting the cache.
+    domain::Plan domain(n,n,0);
+    cost::Coverage<domain::Plan> coverage(domain, 0.5);
+    for(size_t k=0; k < 2; ++k) {
+        camera::Omnidir cam_0(map, p_map, 2, 3, m/2);
+        camera::Omnidir cam_1(map, p_map, 17, 12, m/2);
+        cam_0.geo.cache(&cache);
+        cam_1.geo.cache(&cache);
+        group::proba::AtLeastOne group(p_map,{cam_0, cam_1});
+        coverage(group);
+    }
+
+    // Sensors updated from other threads, which have exited when reporting.
+    std::vector<std::thread> threads;
+    for(size_t t=0; t < 3; ++t) {
+        threads.emplace_back([&map, &p_map, &cache, t, m]() {
+            camera::Omnidir cam(map, p_map, 4 * t, 18, m/2);
+            cam.geo.cache(&cache);
+            cam.geo.prepare();
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+
+    if(trace::enabled()) {
+        const size_t updates = 2 * 2 + 3;
+        if(total(trace::Phase::update).calls != updates) {
+            std::cerr << "Unexpected updates: " << total(trace::Phase::update).calls << std::endl;
+            errors++;
+        }
+        if(total(trace::Phase::cache_hit).calls != cache.hits()
+           or total(trace::Phase::cache_miss).calls != cache.misses()
+           or total(trace::Phase::visibility).calls != cache.misses()
+           or cache.hits() + cache.misses() != updates) {
+            std::cerr << "Cache counters differ" << std::endl;
+            errors++;
+        }
+        if(total(trace::Phase::coverage).calls != 2
+           or total(trace::Phase::coverage).cells != 2 * n * n
+           or total(trace::Phase::rows).calls != 2
+           or total(trace::Phase::projection).calls < 4) {
+            std::cerr << "Unexpected evaluation counters" << std::endl;
+            errors++;
+        }
+        if(total(trace::Phase::coverage).ns < total(trace::Phase::rows).ns) {
+            std::cerr << "Nested phase longer than its parent" << std::endl;
+            errors++;
+        }
+    }
+
+    // Reports have a line per phase, or are all zeros when disabled.
+    std::ostringstream csv;
+    trace::csv(csv);
+    const std::string lines = csv.str();
+    if(std::count(ALL(lines), '\n') != static_cast<long>(trace::phases + 1)) {
+        std::cerr << "Unexpected CSV report:\n" << csv.str() << std::endl;
+        errors++;
+    }
+    std::ostringstream json;
+    trace::json(json);
+    if(json.str().find("\"cache_miss\"") == std::string::npos) {
+        std::cerr << "Unexpected JSON report:\n" << json.str() << std::endl;
+        errors++;
+    }
+
+    if(not trace::enabled()) {
+        for(const auto& counter : trace::totals()) {
+            if(counter.calls != 0) {
+                std::cerr << "Counted while disabled" << std::endl;
+                errors++;
+            }
+        }
+    }
+    trace::reset();
+    if(trace::enabled() and total(trace::Phase::update).calls != 0) {
+        std::cerr << "Not reset" << std::endl;
+        errors++;
+    }
+
+    return report(errors);
+}
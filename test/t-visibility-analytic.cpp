@@ -0,0 +1,236 @@
+/**
+ * Check that visibility polygons against wall segments see exactly the pixels seen from the sensor,
+ * up to the pixels within one pixel of a shadow edge,
+ * that sensors of an instance built from a wall geometry can use them, cached or not,
+ * and that they fall back to the pixel walls without a geometry.
+ */
+#include <iostream>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <array>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/geom.h>
+#include <Ealain/map/shared.h>
+#include <Ealain/map/geometry.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Side of v from the line (o,u): 1 on the left, -1 on the right, 0 on it.
+int side(const inst::Vertex& o, const inst::Vertex& u, const inst::Vertex& v)
+{
+    const double z = (u[0] - o[0]) * (v[1] - o[1]) - (u[1] - o[1]) * (v[0] - o[0]);
+    return (z > 0) - (z < 0);
+}
+
+// True if the segments [a,b] and [c,d] cross.
+bool crossing(const inst::Vertex& a, const inst::Vertex& b, const inst::Vertex& c, const inst::Vertex& d)
+{
+    return side(a, b, c) * side(a, b, d) < 0 and side(c, d, a) * side(c, d, b) < 0;
+}
+
+// True if the segment [a,b] meets the triangle (u,v,w).
+bool meets(const inst::Vertex& a, const inst::Vertex& b, const inst::Vertex& u, const inst::Vertex& v, const inst::Vertex& w)
+{
+    auto inside = [&](const inst::Vertex& x) {
+        const int s = side(u, v, x) + side(v, w, x) + side(w, u, x);
+        return s == 3 or s == -3;
+    };
+    return inside(a) or inside(b) or crossing(a, b, u, v) or crossing(a, b, v, w) or crossing(a, b, w, u);
+}
+
+/**
+ * Exact visibility from an eye, to check rasterized visibility maps against:
+ * a pixel may differ from it only if a shadow edge passes within one pixel of it.
+ */
+struct Sight
+{
+    std::vector<inst::Segment> walls;
+    inst::Vertex eye;
+    double size[2];
+
+    Sight(const inst::Geometry& geometry, const inst::Vertex& eye, const double size[2])
+        : walls(geometry.segments()), eye(eye), size{size[0], size[1]}
+    {
+        for(const inst::Polygon& polygon : geometry.polygons()) {
+            for(size_t k=0; k < polygon.size(); ++k) {
+                walls.push_back(inst::Segment{polygon[k], polygon[(k+1) % polygon.size()]});
+            }
+        }
+    }
+
+    bool sees(const inst::Vertex& x) const
+    {
+        return std::none_of(ALL(walls), [&](const inst::Segment& w) {return crossing(eye, x, w.from, w.to);});
+    }
+
+    // Corners of the pixel starting at the given real-world point, grown by one pixel on each side.
+    std::vector<inst::Vertex> around(const inst::Vertex& start) const
+    {
+        const inst::Vertex min = {start[0] - size[0], start[1] - size[1]};
+        const inst::Vertex max = {start[0] + 2*size[0], start[1] + 2*size[1]};
+        return {min, {max[0], min[1]}, max, {min[0], max[1]}};
+    }
+
+    // No wall within the hull of the eye and the grown pixel: no shadow edge close to the pixel.
+    bool sees_all(const inst::Vertex& start) const
+    {
+        const std::vector<inst::Vertex> square = around(start);
+        return std::none_of(ALL(walls), [&](const inst::Segment& w) {
+            for(size_t k=0; k < square.size(); ++k) {
+                if(meets(w.from, w.to, eye, square[k], square[(k+1) % square.size()])) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    // Some point of the grown pixel is seen, sampled on a fine grid.
+    bool sees_any(const inst::Vertex& start) const
+    {
+        const std::vector<inst::Vertex> square = around(start);
+        const size_t samples = 12;
+        for(size_t a=0; a <= samples; ++a) {
+            for(size_t b=0; b <= samples; ++b) {
+                if(sees({square[0][0] + 3*size[0] * a / samples, square[0][1] + 3*size[1] * b / samples})) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    const size_t n = 100;
+    const double m = 100;
+    const auto p = inst::rectangle_projection(n, n, 0, m, 0, m);
+    const geom::Box whole{0, 0, n-1, n-1};
+
+    // Nothing blocks the sight: everything is seen.
+    inst::Geometry empty;
+    domain::Bits all(n, n);
+    if(geom::visibility_map_2D(all, empty, p, 30, 60, whole) != n*n) {
+        std::cerr << "Unexpected hidden pixels without walls" << std::endl;
+        errors++;
+    }
+
+    // A wall across the map hides the other side.
+    inst::Geometry across;
+    across.add(inst::Segment{{50, -10}, {50, 110}});
+    domain::Bits half(n, n);
+    geom::visibility_map_2D(half, across, p, 20, 20, whole);
+    for(size_t i=0; i < n; ++i) {
+        for(size_t j=0; j < n; ++j) {
+            if((i < p[0](49.0) and not half(i,j)) or (i > p[0](51.0) and half(i,j))) {
+                std::cerr << "Wrong visibility at " << i << "," << j << " behind a wall" << std::endl;
+                errors++;
+            }
+        }
+    }
+
+    // On a wall, nothing is seen.
+    domain::Bits none(n, n);
+    if(geom::visibility_map_2D(none, across, p, p[0](50.0), 20, whole) != 0) {
+        std::cerr << "Seeing from a wall" << std::endl;
+        errors++;
+    }
+
+    // Random walls: pixels far from any shadow edge are exactly seen or hidden.
+    inst::Geometry geometry;
+    std::uniform_real_distribution<double> coord(0, m);
+    std::uniform_real_distribution<double> length(-15, 15);
+    for(size_t w=0; w < 20; ++w) {
+        const inst::Vertex from = {coord(rng), coord(rng)};
+        geometry.add(inst::Segment{from, {from[0] + length(rng), from[1] + length(rng)}});
+    }
+    geometry.add(inst::Polygon{{70, 70}, {80, 72}, {75, 85}});
+    const inst::Shared instance = inst::share(geometry, p);
+    const double size[2] = {p[0](size_t(1)) - p[0](size_t(0)), p[1](size_t(1)) - p[1](size_t(0))};
+    std::uniform_int_distribution<size_t> cell(0, n-1);
+    size_t differing = 0, sensors = 0;
+    while(sensors < 50) {
+        const size_t i = cell(rng), j = cell(rng);
+        const geom::Box window{i > 30 ? i-30 : 0, j > 30 ? j-30 : 0, std::min(i+30, n-1), std::min(j+30, n-1)};
+        domain::Bits analytic(window.rows(), window.cols());
+        if(geom::visibility_map_2D(analytic, geometry, p, i, j, window) == 0) {
+            continue; // On a wall.
+        }
+        sensors++;
+        const Sight sight(geometry, {p[0](i) + size[0] / 2, p[1](j) + size[1] / 2}, size);
+        for(size_t k=0; k < window.rows(); ++k) {
+            for(size_t l=0; l < window.cols(); ++l) {
+                const inst::Vertex start = {p[0](window.row_min + k), p[1](window.col_min + l)};
+                differing += analytic(k,l) ? not sight.sees_any(start) : sight.sees_all(start);
+            }
+        }
+    }
+    if(differing > 0) {
+        std::cerr << "Analytic visibility wrong on " << differing << " pixels away from the shadows edges" << std::endl;
+        errors++;
+    }
+
+    // Same coverages for analytic sensors with and without the cache of the instance.
+    const inst::Shared cached = inst::share(geometry, p, 1 << 24, geom::Visibility::analytic);
+    std::vector<std::vector<double>> layouts(4);
+    for(auto& layout : layouts) {
+        for(size_t c=0; c < 2*3; ++c) {
+            layout.push_back(coord(rng));
+        }
+    }
+    for(const auto& layout : layouts) {
+        double coverages[2];
+        for(size_t k=0; k < 2; ++k) {
+            camera::Omnidir::Domain domain(p);
+            group::proba::AtLeastOne group(p);
+            std::vector<camera::Omnidir> cameras;
+            for(size_t c=0; c < layout.size(); c += 2) {
+                cameras.emplace_back(k == 0 ? instance : cached, layout[c], layout[c+1], m/3);
+                if(k == 0) {
+                    cameras.back().geo.engine(geom::Visibility::analytic);
+                }
+            }
+            for(auto& camera : cameras) {
+                group.bind(camera);
+            }
+            coverages[k] = cost::make_coverage(domain, 0.5)(group);
+        }
+        if(coverages[0] != coverages[1] or coverages[0] == 0) {
+            std::cerr << "Differing analytic coverages: " << coverages[0] << " " << coverages[1] << std::endl;
+            errors++;
+        }
+    }
+    if(cached->cache()->misses() == 0) {
+        std::cerr << "Analytic cache not used" << std::endl;
+        errors++;
+    }
+
+    // Without a wall geometry, the analytic engine sees the same pixel walls as the others.
+    auto rectangle = inst::rectangle(n, n, m, m);
+    random_walls(rectangle.first, 0.05, rng);
+    const inst::Shared pixels = inst::share(std::move(rectangle));
+    const std::array<size_t,2> ij = p(std::array<double,2>{m/3, m/2});
+    for(const double range : {m/5, m}) {
+        camera::Omnidir camera(pixels, m/3, m/2, range);
+        camera.geo.engine(geom::Visibility::analytic);
+        const geom::Box& box = camera.geo.box();
+        domain::Bits traced(box.rows(), box.cols());
+        geom::visibility_map_2D(traced, pixels->walls(), ij[0], ij[1], box, geom::Visibility::ray_tracing);
+        if(not (camera.geo.visibility() == traced)) {
+            std::cerr << "Analytic engine without geometry differs from the pixel walls" << std::endl;
+            errors++;
+        }
+    }
+
+    return report(errors);
+}
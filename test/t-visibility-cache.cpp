@@ -0,0 +1,94 @@
+/**
+ * Check that sensors sharing a visibility cache sense exactly as without,
+ * and that the cache respects its memory budget, from several threads.
+ */
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/cache.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 30;
+    double m = 30;
+    auto d = inst::rectangle(n,n,m,m);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    random_walls(map, 0.1, rng);
+
+    // Same detection with and without cache, on revisited positions.
+    geom::VisibilityCache cache(map, 25 * n * n);
+    std::uniform_int_distribution<size_t> coord(0, 4);
+    for(size_t step=0; step < 100; ++step) {
+        const double x = 5 * coord(rng);
+        const double y = 5 * coord(rng);
+        camera::Omnidir alone(map, p_map, x, y, m/3);
+        camera::Omnidir shared(map, p_map, x, y, m/3);
+        shared.geo.cache(&cache);
+
+        camera::Omnidir::Domain dom_alone(n,n,0);
+        camera::Omnidir::Domain dom_shared(n,n,0);
+        dom_alone = alone(dom_alone);
+        dom_shared = shared(dom_shared);
+        if(not std::equal(ALL(dom_alone.buffer()), std::begin(dom_shared.buffer()))) {
+            std::cerr << "Differing detection with cache at step " << step << std::endl;
+            errors++;
+        }
+    }
+    if(cache.hits() + cache.misses() != 100 or cache.misses() > 25) {
+        std::cerr << "Unexpected counters: " << cache.hits() << " hits, " << cache.misses() << " misses" << std::endl;
+        errors++;
+    }
+    if(cache.memory() > cache.budget()) {
+        std::cerr << "Budget exceeded" << std::endl;
+        errors++;
+    }
+
+    // Concurrent requests on a small budget.
+    cache.clear();
+    cache.budget(3 * domain::Bits(n, n).memory());
+    std::vector<std::thread> threads;
+    std::vector<size_t> thread_errors(4, 0);
+    for(size_t t=0; t < thread_errors.size(); ++t) {
+        threads.emplace_back([&map, &cache, &thread_errors, t, n]() {
+            const geom::Box window = geom::whole(map);
+            for(size_t k=0; k < 50; ++k) {
+                const size_t i = (k * 7 + t) % n;
+                const size_t j = (k * 3) % n;
+                domain::PlanT<char> expected(n, n, 0);
+                geom::visibility_map_2D_ray_tracing(expected, map, i, j, window);
+                auto got = cache(i, j, window);
+                if(domain::Bits(expected) != *got) {
+                    thread_errors[t]++;
+                }
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(size_t e : thread_errors) {
+        errors += e;
+    }
+    if(cache.memory() > cache.budget() or cache.evictions() == 0) {
+        std::cerr << "Budget not enforced" << std::endl;
+        errors++;
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,124 @@
+/**
+ * Check that a precomputed visibility index gives exactly the traced visibility maps,
+ * whatever the number of threads used to build it.
+ */
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/index.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+std::string content(const std::string& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    size_t n = 25;
+    size_t k = 21;
+    auto d = inst::rectangle(n,k,n,k);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+    random_walls(map, 0.15, rng);
+
+    geom::VisibilityIndex::build(map, "t-visibility-index-1.bin", 1);
+    geom::VisibilityIndex::build(map, "t-visibility-index-3.bin", 3);
+    if(content("t-visibility-index-1.bin") != content("t-visibility-index-3.bin")) {
+        std::cerr << "Index depends on the number of threads" << std::endl;
+        errors++;
+    }
+
+    geom::VisibilityIndex index("t-visibility-index-3.bin");
+    const geom::Box window{3, 4, 17, 12};
+    for(size_t si=0; si < n; ++si) {
+        for(size_t sj=0; sj < k; ++sj) {
+            domain::PlanT<char> traced(n, k, 0);
+            domain::PlanT<char> read(n, k, 0);
+            geom::visibility_map_2D_ray_tracing(traced, map, si, sj);
+            index.fill(read, si, sj, geom::whole(map));
+            bool same = std::equal(ALL(traced.buffer()), std::begin(read.buffer()));
+            for(size_t i=0; i < n; ++i) {
+                for(size_t j=0; j < k; ++j) {
+                    same = same and (index(si, sj, i, j) == (traced(i,j) == 1));
+                }
+            }
+            if(window.contains(si, sj)) {
+                domain::PlanT<char> windowed(window.rows(), window.cols(), 0);
+                index.fill(windowed, si, sj, window);
+                for(size_t i=0; i < window.rows(); ++i) {
+                    for(size_t j=0; j < window.cols(); ++j) {
+                        same = same and windowed(i,j) == traced(window.row_min+i, window.col_min+j);
+                    }
+                }
+            }
+            if(not same) {
+                std::cerr << "Differing visibility from " << si << "," << sj << std::endl;
+                errors++;
+            }
+        }
+    }
+
+    // Cameras reading the index sense the same.
+    camera::Omnidir traced(map, p_map, 12, 10, 8);
+    camera::Omnidir read(map, p_map, 12, 10, 8);
+    read.geo.index(&index);
+    camera::Omnidir::Domain dom_traced(n,k,0);
+    camera::Omnidir::Domain dom_read(n,k,0);
+    dom_traced = traced(dom_traced);
+    dom_read = read(dom_read);
+    if(not std::equal(ALL(dom_traced.buffer()), std::begin(dom_read.buffer()))) {
+        std::cerr << "Differing detection with index" << std::endl;
+        errors++;
+    }
+
+    // Unreadable, truncated or corrupt files are reported.
+    const std::string valid = content("t-visibility-index-3.bin");
+    std::ofstream("t-visibility-index-truncated.bin", std::ios::binary) << valid.substr(0, valid.size() / 2);
+    std::ofstream("t-visibility-index-magic.bin", std::ios::binary) << "X" << valid.substr(1);
+    for(const char* filename : {"t-visibility-index-missing.bin", "t-visibility-index-truncated.bin", "t-visibility-index-magic.bin"}) {
+        try {
+            geom::VisibilityIndex bad(filename);
+            std::cerr << "Unreported bad index " << filename << std::endl;
+            errors++;
+        } catch(const std::runtime_error&) {}
+    }
+    // Row max of the first non-empty record out of the map.
+    std::string corrupt = valid;
+    const size_t records = (3 + n*k + 1) * sizeof(uint64_t);
+    corrupt[records + 8] = corrupt[records + 9] = corrupt[records + 10] = corrupt[records + 11] = '\xff';
+    std::ofstream("t-visibility-index-record.bin", std::ios::binary) << corrupt;
+    size_t reported = 0;
+    geom::VisibilityIndex bad("t-visibility-index-record.bin");
+    for(size_t si=0; si < n; ++si) {
+        for(size_t sj=0; sj < k; ++sj) {
+            domain::Bits read(n, k);
+            try {
+                bad.fill(read, si, sj, geom::whole(map));
+            } catch(const std::runtime_error&) {
+                reported++;
+            }
+        }
+    }
+    if(reported != 1) {
+        std::cerr << "Unreported corrupt record" << std::endl;
+        errors++;
+    }
+
+    return report(errors);
+}
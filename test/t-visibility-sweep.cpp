@@ -0,0 +1,112 @@
+/**
+ * Check that the sweep visibility algorithm computes exactly the same maps as the ray tracing one,
+ * and that restricting them to a window does not change what is seen.
+ */
+#include <iostream>
+#include <random>
+#include <algorithm>
+
+#include <Ealain/utils.h>
+#include <Ealain/cost.h>
+#include <Ealain/map/geom.h>
+#include <Ealain/map/plan.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/detection/group.h>
+#include <Ealain/detection/camera.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+// Compare both algorithms for every sensor location, return the number of differing maps.
+size_t compare(const inst::Map& map)
+{
+    size_t errors = 0;
+    for(size_t i=0; i < map.size(); ++i) {
+        for(size_t j=0; j < map[0].size(); ++j) {
+            domain::PlanT<char> traced(map.size(), map[0].size(), 0);
+            domain::PlanT<char> swept(map.size(), map[0].size(), 0);
+            unsigned int n_traced = geom::visibility_map_2D_ray_tracing(traced, map, i, j);
+            unsigned int n_swept = geom::visibility_map_2D_sweep(swept, map, i, j);
+            if(n_traced != n_swept
+               or not std::equal(ALL(traced.buffer()), std::begin(swept.buffer()))) {
+                std::cerr << "Differing visibility from " << i << "," << j << std::endl;
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+// Check that both algorithms restricted to windows around the sensor see the same as without window.
+size_t compare_windows(const inst::Map& map, size_t radius)
+{
+    size_t errors = 0;
+    for(size_t i=0; i < map.size(); ++i) {
+        for(size_t j=0; j < map[0].size(); ++j) {
+            domain::PlanT<char> full(map.size(), map[0].size(), 0);
+            geom::visibility_map_2D_ray_tracing(full, map, i, j);
+
+            geom::Box window{
+                i > radius ? i-radius : 0,
+                j > radius ? j-radius : 0,
+                std::min(i+radius, map.size()-1),
+                std::min(j+radius, map[0].size()-1)};
+            domain::PlanT<char> traced(window.rows(), window.cols(), 0);
+            domain::PlanT<char> swept(window.rows(), window.cols(), 0);
+            geom::visibility_map_2D_ray_tracing(traced, map, i, j, window);
+            geom::visibility_map_2D_sweep(swept, map, i, j, window);
+
+            for(size_t wi=0; wi < window.rows(); ++wi) {
+                for(size_t wj=0; wj < window.cols(); ++wj) {
+                    const char expected = full(window.row_min+wi, window.col_min+wj);
+                    if(traced(wi,wj) != expected or swept(wi,wj) != expected) {
+                        std::cerr << "Differing windowed visibility from " << i << "," << j << std::endl;
+                        errors++;
+                        wi = window.rows();
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    // Same instance and cameras as t-visibility.
+    size_t n = 20;
+    double m = 20;
+    auto d = inst::rectangle(n,n,m,m);
+    inst::Map map = d.first;
+    proj::Projection<double,size_t> p_map = d.second;
+
+    camera::Omnidir::Domain dom_traced(n,n,0);
+    camera::Omnidir::Domain dom_swept(n,n,0);
+    camera::Omnidir cam_0(map, p_map, 0, 12, m/2);
+    camera::Omnidir cam_1(map, p_map, 12, 0, m/2);
+    group::proba::AtLeastOne group(p_map,{cam_0, cam_1});
+    dom_traced = group(dom_traced);
+    cam_0.geo.engine(geom::Visibility::sweep);
+    cam_1.geo.engine(geom::Visibility::sweep);
+    dom_swept = group(dom_swept);
+    if(not std::equal(ALL(dom_traced.buffer()), std::begin(dom_swept.buffer()))) {
+        std::cerr << "Differing detection on t-visibility instance" << std::endl;
+        errors++;
+    }
+    errors += compare(map);
+
+    // Walls, on square and non-square maps.
+    for(double density : {0.05, 0.2, 0.5}) {
+        errors += compare(random_walls(23, 23, density, rng));
+        errors += compare(random_walls(17, 29, density, rng));
+        errors += compare(random_walls(31, 12, density, rng));
+        errors += compare_windows(random_walls(23, 19, density, rng), 5);
+    }
+
+    return report(errors);
+}
@@ -0,0 +1,115 @@
+/**
+ * Check that walls given as segments and polygons are rasterized at any discretisation,
+ * clipped to the instance, and read back from their text format.
+ */
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <Ealain/map/geom.h>
+#include <Ealain/map/shared.h>
+#include <Ealain/map/instance.h>
+#include <Ealain/map/geometry.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+size_t count(const inst::Map& map)
+{
+    size_t n = 0;
+    for(const auto& row : map) {
+        for(double cell : row) {
+            n += cell == 1;
+        }
+    }
+    return n;
+}
+
+int main()
+{
+    size_t errors = 0;
+
+    // A wall along x = 5, from y = 2 to y = 8, and a filled square, on a 10×10 area.
+    inst::Geometry geometry;
+    geometry.add(inst::Segment{{5, 2}, {5, 8}});
+    geometry.add(inst::Polygon{{1, 1}, {3, 1}, {3, 3}, {1, 3}});
+
+    for(size_t n : {10, 19, 40, 100}) {
+        auto d = inst::rectangle_geometry(geometry, n, n, 10, 10);
+        const inst::Map& map = d.first;
+        const auto& p = d.second;
+        inst::Map expected(n, std::vector<double>(n, 0));
+        for(size_t j = p[1](2.0); j <= p[1](8.0); ++j) {
+            expected[p[0](5.0)][j] = 1;
+        }
+        for(size_t i = p[0](1.0); i <= p[0](3.0); ++i) {
+            for(size_t j = p[1](1.0); j <= p[1](3.0); ++j) {
+                expected[i][j] = 1;
+            }
+        }
+        if(map != expected) {
+            std::cerr << "Unexpected walls at " << n << "x" << n << std::endl;
+            errors++;
+        }
+
+        // Straight into bits, for a shared instance.
+        const inst::Shared shared = inst::share(geometry, p);
+        if(shared->walls() != geom::walls(map)) {
+            std::cerr << "Differing bits at " << n << "x" << n << std::endl;
+            errors++;
+        }
+    }
+
+    // Diagonal walls are connected.
+    inst::Geometry diagonal;
+    diagonal.add(inst::Segment{{0, 0}, {10, 10}});
+    const inst::Map line = inst::rectangle_geometry(diagonal, 50, 50, 10, 10).first;
+    for(size_t i=0; i < 50; ++i) {
+        if(line[i][i] != 1) {
+            std::cerr << "Diagonal wall not connected at " << i << std::endl;
+            errors++;
+        }
+    }
+
+    // Clipped to the instance.
+    inst::Geometry outside;
+    outside.add(inst::Segment{{-5, 5}, {15, 5}});
+    outside.add(inst::Segment{{-5, -5}, {-1, 20}});
+    outside.add(inst::Polygon{{8, 8}, {20, 8}, {20, 20}, {8, 20}});
+    const inst::Map clipped = inst::rectangle_geometry(outside, 10, 10, 10, 10).first;
+    // The segment on column 4 of all rows, and the 3×3 pixels of the square within the instance.
+    if(count(clipped) != 10 + 3*3) {
+        std::cerr << "Unexpected clipped walls: " << count(clipped) << std::endl;
+        errors++;
+    }
+    for(size_t i=0; i < 10; ++i) {
+        if(clipped[i][4] != 1) {
+            std::cerr << "Clipped wall missing at " << i << ",4" << std::endl;
+            errors++;
+        }
+    }
+
+    // Text format.
+    inst::save_geometry("t-wall-geometry.txt", geometry);
+    {
+        std::ofstream file("t-wall-geometry.txt", std::ios::app);
+        file << "\n# comment\nsegment 1 2 3\npolygon 1 1 2 2\n";
+    }
+    const inst::Geometry loaded = inst::load_geometry("t-wall-geometry.txt");
+    if(loaded.segments().size() != 1 or loaded.polygons().size() != 1
+       or inst::rectangle_geometry(loaded, 40, 40, 10, 10).first != inst::rectangle_geometry(geometry, 40, 40, 10, 10).first) {
+        std::cerr << "Differing geometry once saved" << std::endl;
+        errors++;
+    }
+
+    // Missing files are reported.
+    try {
+        inst::load_geometry("t-wall-geometry-missing.txt");
+        std::cerr << "Unreported missing geometry" << std::endl;
+        errors++;
+    } catch(const std::runtime_error&) {}
+
+    return report(errors);
+}
@@ -0,0 +1,76 @@
+/**
+ * Check that csv files of walls are loaded as expected, whatever their size,
+ * malformed lines being skipped, and that a missing file is reported.
+ */
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <vector>
+#include <stdexcept>
+
+#include <Ealain/map/instance.h>
+
+#include "fixtures.h"
+
+using namespace ealain;
+
+int main()
+{
+    size_t errors = 0;
+    std::mt19937 rng(0);
+
+    // Pixels, with blank, windows-style, malformed and out of the map lines, and no final newline.
+    {
+        std::ofstream csv("t-walls-csv-small.csv", std::ios::binary);
+        csv << "1,2\n\n 3 , 4\r\n5;6\nabc\n7\n8,9,\n-1,2\n10,0\n0,12\n2,10";
+    }
+    inst::Map expected(11, std::vector<double>(12, 0));
+    expected[1][2] = expected[3][4] = expected[8][9] = expected[10][0] = expected[2][10] = 1;
+    if(inst::rectangle_walls("t-walls-csv-small.csv", 11, 12, 11, 12).first != expected) {
+        std::cerr << "Unexpected walls from a small file" << std::endl;
+        errors++;
+    }
+
+    // Large enough to be parsed by several threads.
+    const size_t n = 500;
+    std::uniform_int_distribution<size_t> cell(0, n-1);
+    expected.assign(n, std::vector<double>(n, 0));
+    {
+        std::ofstream csv("t-walls-csv-large.csv");
+        for(size_t w=0; w < 200000; ++w) {
+            const size_t i = cell(rng), j = cell(rng);
+            expected[i][j] = 1;
+            csv << i << "," << j << "\n";
+        }
+    }
+    if(inst::rectangle_walls("t-walls-csv-large.csv", n, n, n, n).first != expected) {
+        std::cerr << "Unexpected walls from a large file" << std::endl;
+        errors++;
+    }
+
+    // Normalized coordinates.
+    {
+        std::ofstream csv("t-walls-csv-numeric.csv");
+        csv << "0,0\n0.5,0.25\n1,1\n2,0\n";
+    }
+    auto numeric = inst::rectangle_walls_numeric("t-walls-csv-numeric.csv", 10, 10, 10, 10);
+    expected.assign(10, std::vector<double>(10, 0));
+    expected[0][0] = expected[4][2] = expected[9][9] = 1;
+    if(numeric.first != expected) {
+        std::cerr << "Unexpected walls from normalized coordinates" << std::endl;
+        errors++;
+    }
+
+    // No filename, no walls, but a missing file is an error.
+    if(inst::rectangle_walls("", 5, 5, 5, 5).first != inst::Map(5, std::vector<double>(5, 0))) {
+        std::cerr << "Walls without a file" << std::endl;
+        errors++;
+    }
+    try {
+        inst::rectangle_walls("t-walls-csv-missing.csv", 5, 5, 5, 5);
+        std::cerr << "Walls from a missing file" << std::endl;
+        errors++;
+    } catch(const std::runtime_error&) {}
+
+    return report(errors);
+}